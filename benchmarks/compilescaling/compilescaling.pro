@@ -0,0 +1,13 @@
+QT = core testlib
+
+TEMPLATE = app
+TARGET = tst_bench_compilescaling
+
+SOURCES += main.cpp
+OTHER_FILES += budgets.json
+
+# The benchmark compiles generated sources with Verdigris and the Qt headers
+DEFINES += VERDIGRIS_SRC_DIR=\\\"$$clean_path($$PWD/../../src)\\\" \
+           QT_HEADERS_DIR=\\\"$$[QT_INSTALL_HEADERS]\\\" \
+           QT_LIBS_DIR=\\\"$$[QT_INSTALL_LIBS]\\\" \
+           BUDGETS_FILE=\\\"$$PWD/budgets.json\\\"
@@ -0,0 +1,500 @@
+/****************************************************************************
+ *  Copyright (C) 2016-2018 Woboq GmbH
+ *  Olivier Goffart <ogoffart at woboq.com>
+ *  https://woboq.com/
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Compile time scaling benchmark
+
+ Generates synthetic Verdigris classes along several axes, compiles them with every available
+ compiler and C++ standard, and records the wall time, the peak memory, and the total reported
+ by the compiler itself (-ftime-trace for Clang, -ftime-report for GCC).
+ A row fails when one of the measures exceeds its budget from budgets.json.
+
+ Axes (the size is the amount of the given entity):
+   signals       one class with N signals
+   slots         one class with N slots
+   properties    one class with N properties, each with its own NOTIFY signal
+   enums         one class with a W_ENUM of N values
+   templates     N instantiations of a class template using W_OBJECT_IMPL
+   inline        N translation units including a header with W_OBJECT_IMPL_INLINE (C++17)
+
+ Environment variables:
+   VERDIGRIS_BENCH_COMPILERS       compilers to use (default: "g++ clang++"; missing ones are skipped)
+   VERDIGRIS_BENCH_STANDARDS       C++ standards to use (default: "14 17 20")
+   VERDIGRIS_BENCH_AXES            axes to run (default: all of them)
+   VERDIGRIS_BENCH_BUDGETS         budget file (default: budgets.json next to this file)
+   VERDIGRIS_BENCH_BUDGET_FACTOR   multiply all the budgets, for slower or faster machines
+   VERDIGRIS_BENCH_RESULTS         append the measures to this CSV file
+   VERDIGRIS_BENCH_WRITE_BUDGETS   write a budget file from the measures, with a 50% margin
+
+ The budgets are in seconds (wall, trace) and megabytes (rss). They are looked up from the most
+ specific key to the least specific one: "axis/size/compiler/c++std", "axis/size/compiler",
+ "axis/size". A measure without budget is only reported.
+ The budgets.json shipped here is empty, so the measures are only reported: no budget has been
+ measured with the real Qt headers yet. Write a budget file on the machine running the benchmark
+ with VERDIGRIS_BENCH_WRITE_BUDGETS, for every compiler and measure, to enable the checks.
+
+ */
+
+#include <QtCore>
+#include <qtest.h>
+#include <numeric>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+extern char **environ;
+#endif
+
+namespace {
+
+/// Source files generated for one row. The first file is the header, if any, and is not compiled.
+struct Sources {
+    QVector<QPair<QString, QByteArray>> files;
+    bool hasHeader = false;
+    bool needsCpp17 = false;
+};
+
+/// Measures of the compilation of one row
+struct Measure {
+    double wall = 0;  // seconds
+    double rss = 0;   // MB, peak of the compiler processes
+    double trace = -1; // seconds, total reported by the compiler, or -1 if not available
+};
+
+QByteArray repeat(int n, const char *pattern)
+{
+    QByteArray r;
+    for (int i = 0; i < n; ++i)
+        r += QByteArray(pattern).replace("%1", QByteArray::number(i));
+    return r;
+}
+
+const char prologue[] = "#include <QtCore/QObject>\n#include <QtCore/QString>\n#include <wobjectimpl.h>\n\n";
+
+Sources generateSignals(int n)
+{
+    Sources s;
+    s.files.append({ QStringLiteral("signals.cpp"), prologue
+        + QByteArray("class Object : public QObject {\n    W_OBJECT(Object)\npublic:\n")
+        + repeat(n, "    void signal%1(int value)\n    W_SIGNAL(signal%1, value)\n")
+        + "};\nW_OBJECT_IMPL(Object)\n" });
+    return s;
+}
+
+Sources generateSlots(int n)
+{
+    Sources s;
+    s.files.append({ QStringLiteral("slots.cpp"), prologue
+        + QByteArray("class Object : public QObject {\n    W_OBJECT(Object)\npublic:\n")
+        + repeat(n, "    void slot%1(int) {}\n    W_SLOT(slot%1)\n")
+        + "};\nW_OBJECT_IMPL(Object)\n" });
+    return s;
+}
+
+Sources generateProperties(int n)
+{
+    // Same pattern as tests/manyproperties
+    Sources s;
+    s.files.append({ QStringLiteral("properties.cpp"), prologue
+        + QByteArray("class Object : public QObject {\n    W_OBJECT(Object)\npublic:\n")
+        + repeat(n, "    QString m_prop%1;\n"
+                    "    void prop%1Changed()\n    W_SIGNAL(prop%1Changed)\n"
+                    "    W_PROPERTY(QString, prop%1 MEMBER m_prop%1 NOTIFY prop%1Changed)\n")
+        + "};\nW_OBJECT_IMPL(Object)\n" });
+    return s;
+}
+
+Sources generateEnums(int n)
+{
+    QByteArray values = repeat(n, "Value%1, ");
+    values.chop(2);
+    Sources s;
+    s.files.append({ QStringLiteral("enums.cpp"), prologue
+        + QByteArray("class Object : public QObject {\n    W_OBJECT(Object)\npublic:\n")
+        + "    enum Values { " + values + " };\n"
+        + "    W_ENUM(Values, " + values + ")\n"
+        + "};\nW_OBJECT_IMPL(Object)\n" });
+    return s;
+}
+
+Sources generateTemplates(int n)
+{
+    Sources s;
+    s.files.append({ QStringLiteral("templates.cpp"), prologue
+        + QByteArray("template<typename T> class Object : public QObject {\n    W_OBJECT(Object)\npublic:\n")
+        + repeat(10, "    void signal%1(int value)\n    W_SIGNAL(signal%1, value)\n")
+        + repeat(10, "    void slot%1(int) {}\n    W_SLOT(slot%1)\n")
+        + "    int m_value = 0;\n    W_PROPERTY(int, value MEMBER m_value NOTIFY signal0)\n"
+        + "};\nW_OBJECT_IMPL(Object<T>, template<typename T>)\n\n"
+        + "template<int> struct Tag {};\n"
+        + repeat(n, "template class Object<Tag<%1>>;\n") });
+    return s;
+}
+
+Sources generateInline(int n)
+{
+    Sources s;
+    s.hasHeader = true;
+    s.needsCpp17 = true;
+    s.files.append({ QStringLiteral("inline.h"), "#pragma once\n" + QByteArray(prologue)
+        + QByteArray("class Object : public QObject {\n    W_OBJECT(Object)\npublic:\n")
+        + repeat(20, "    void signal%1(int value)\n    W_SIGNAL(signal%1, value)\n")
+        + repeat(20, "    void slot%1(int) {}\n    W_SLOT(slot%1)\n")
+        + "};\nW_OBJECT_IMPL_INLINE(Object)\n" });
+    for (int i = 0; i < n; ++i) {
+        s.files.append({ QStringLiteral("inline%1.cpp").arg(i),
+            "#include \"inline.h\"\nconst QMetaObject *metaObject" + QByteArray::number(i)
+            + "() { return &Object::staticMetaObject; }\n" });
+    }
+    return s;
+}
+
+struct Axis {
+    const char *name;
+    Sources (*generate)(int);
+    int sizes[3];
+};
+
+const Axis axes[] = {
+    { "signals", generateSignals, { 10, 100, 500 } },
+    { "slots", generateSlots, { 10, 100, 500 } },
+    { "properties", generateProperties, { 10, 100, 400 } },
+    { "enums", generateEnums, { 10, 100, 1000 } },
+    { "templates", generateTemplates, { 1, 10, 50 } },
+    { "inline", generateInline, { 1, 4, 16 } },
+};
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+constexpr auto SkipEmptyParts = Qt::SkipEmptyParts;
+#else
+constexpr auto SkipEmptyParts = QString::SkipEmptyParts;
+#endif
+
+QString environment(const char *name, const char *defaultValue = "")
+{
+    const QByteArray value = qgetenv(name);
+    return QString::fromLocal8Bit(value.isEmpty() ? QByteArray(defaultValue) : value);
+}
+
+QStringList environmentList(const char *name, const char *defaultValue)
+{
+    return environment(name, defaultValue).split(QRegularExpression(QStringLiteral("[\\s,]+")),
+                                                 SkipEmptyParts);
+}
+
+bool isClang(const QString &compiler)
+{
+    return QFileInfo(compiler).fileName().contains(QLatin1String("clang"));
+}
+
+/// Total wall time of a GCC -ftime-report, in seconds, or -1
+double parseTimeReport(const QByteArray &report)
+{
+    // " TOTAL :  10.62 ( 99%)   0.46 ( 97%)  11.08 ( 99%)  1016M" (older versions have no percentages)
+    for (QString line : QString::fromLocal8Bit(report).split(QLatin1Char('\n'))) {
+        if (!line.trimmed().startsWith(QLatin1String("TOTAL")))
+            continue;
+        line.remove(QRegularExpression(QStringLiteral("\\(\\s*\\d+%\\)")));
+        line = line.mid(line.indexOf(QLatin1Char(':')) + 1);
+        const QStringList numbers = line.split(QLatin1Char(' '), SkipEmptyParts);
+        if (numbers.size() >= 3) // usr, sys, wall
+            return numbers.at(2).toDouble();
+    }
+    return -1;
+}
+
+/// Total of a Clang -ftime-trace file, in seconds, or -1
+double parseTimeTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+    const QJsonArray events = QJsonDocument::fromJson(file.readAll()).object()
+        .value(QLatin1String("traceEvents")).toArray();
+    for (const QJsonValue &event : events) {
+        const QJsonObject o = event.toObject();
+        if (o.value(QLatin1String("name")).toString() == QLatin1String("Total ExecuteCompiler"))
+            return o.value(QLatin1String("dur")).toDouble() / 1e6;
+    }
+    return -1;
+}
+
+} // namespace
+
+class CompileScalingBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void compile_data();
+    void compile();
+
+private:
+    bool run(const QStringList &arguments, const QString &logFile, Measure &measure);
+    bool supportsStandard(const QString &compiler, const QString &standard);
+    QJsonObject budget(const QString &axis, int size, const QString &compiler, const QString &standard) const;
+
+    QJsonObject m_budgets;
+    double m_budgetFactor = 1;
+    QJsonObject m_newBudgets;
+    QHash<QString, bool> m_supportedStandards;
+};
+
+void CompileScalingBenchmark::initTestCase()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("The compiler processes are only measured on Unix");
+#endif
+    const QString budgetFile = environment("VERDIGRIS_BENCH_BUDGETS", BUDGETS_FILE);
+    QFile file(budgetFile);
+    if (file.open(QIODevice::ReadOnly)) {
+        QJsonParseError error;
+        m_budgets = QJsonDocument::fromJson(file.readAll(), &error).object().value(QLatin1String("budgets")).toObject();
+        QVERIFY2(error.error == QJsonParseError::NoError, qPrintable(budgetFile + QLatin1String(": ") + error.errorString()));
+    }
+    bool ok = false;
+    const double factor = environment("VERDIGRIS_BENCH_BUDGET_FACTOR").toDouble(&ok);
+    if (ok)
+        m_budgetFactor = factor;
+}
+
+void CompileScalingBenchmark::cleanupTestCase()
+{
+    const QString fileName = environment("VERDIGRIS_BENCH_WRITE_BUDGETS");
+    if (fileName.isEmpty() || m_newBudgets.isEmpty())
+        return;
+    QFile file(fileName);
+    QVERIFY2(file.open(QIODevice::WriteOnly), qPrintable(file.errorString()));
+    file.write(QJsonDocument(QJsonObject{ { QLatin1String("budgets"), m_newBudgets } }).toJson());
+}
+
+void CompileScalingBenchmark::compile_data()
+{
+    QTest::addColumn<QString>("axis");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<QString>("compiler");
+    QTest::addColumn<QString>("standard");
+
+    const QStringList selectedAxes = environmentList("VERDIGRIS_BENCH_AXES", "");
+    for (const QString &compiler : environmentList("VERDIGRIS_BENCH_COMPILERS", "g++ clang++")) {
+        if (QStandardPaths::findExecutable(compiler).isEmpty() && !QFileInfo(compiler).isExecutable())
+            continue;
+        for (const QString &standard : environmentList("VERDIGRIS_BENCH_STANDARDS", "14 17 20")) {
+            for (const Axis &axis : axes) {
+                if (!selectedAxes.isEmpty() && !selectedAxes.contains(QLatin1String(axis.name)))
+                    continue;
+                for (int size : axis.sizes) {
+                    QTest::newRow(qPrintable(QStringLiteral("%1/%2/%3/c++%4").arg(QString::fromLatin1(axis.name))
+                                             .arg(size).arg(QFileInfo(compiler).fileName(), standard)))
+                        << QString::fromLatin1(axis.name) << size << compiler << standard;
+                }
+            }
+        }
+    }
+}
+
+void CompileScalingBenchmark::compile()
+{
+    QFETCH(QString, axis);
+    QFETCH(int, size);
+    QFETCH(QString, compiler);
+    QFETCH(QString, standard);
+
+    const Axis *a = std::find_if(std::begin(axes), std::end(axes),
+                                 [&](const Axis &candidate) { return axis == QLatin1String(candidate.name); });
+    const Sources sources = a->generate(size);
+    if (sources.needsCpp17 && standard.toInt() < 17)
+        QSKIP("Requires C++17");
+    if (!supportsStandard(compiler, standard))
+        QSKIP(qPrintable(QFileInfo(compiler).fileName() + QLatin1String(" does not support -std=c++") + standard));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    for (const auto &f : sources.files) {
+        QFile file(dir.filePath(f.first));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(f.second);
+    }
+
+    const bool clang = isClang(compiler);
+    Measure total;
+    QVector<double> traces;
+    for (int i = sources.hasHeader ? 1 : 0; i < sources.files.size(); ++i) {
+        const QString source = dir.filePath(sources.files.at(i).first);
+        const QString object = dir.filePath(QFileInfo(source).completeBaseName() + QLatin1String(".o"));
+        const QString log = dir.filePath(QFileInfo(source).completeBaseName() + QLatin1String(".log"));
+        QStringList arguments = {
+            compiler, QLatin1String("-std=c++") + standard, QStringLiteral("-O2"), QStringLiteral("-fPIC"),
+            QStringLiteral("-w"), QStringLiteral("-c"),
+            clang ? QStringLiteral("-ftime-trace") : QStringLiteral("-ftime-report"),
+            QLatin1String("-I" VERDIGRIS_SRC_DIR), QLatin1String("-I" QT_HEADERS_DIR),
+            QLatin1String("-I" QT_HEADERS_DIR "/QtCore"),
+            source, QStringLiteral("-o"), object };
+#ifdef Q_OS_DARWIN
+        arguments.append(QLatin1String("-F" QT_LIBS_DIR)); // Qt frameworks
+#endif
+        Measure m;
+        if (!run(arguments, log, m)) {
+            QFile file(log);
+            file.open(QIODevice::ReadOnly);
+            QFAIL(qPrintable(QLatin1String("Compilation failed: ") + arguments.join(QLatin1Char(' '))
+                             + QLatin1Char('\n') + QString::fromLocal8Bit(file.readAll().left(4000))));
+        }
+        if (clang) {
+            m.trace = parseTimeTrace(dir.filePath(QFileInfo(source).completeBaseName() + QLatin1String(".json")));
+        } else {
+            QFile file(log);
+            if (file.open(QIODevice::ReadOnly))
+                m.trace = parseTimeReport(file.readAll());
+        }
+        total.wall += m.wall;
+        total.rss = qMax(total.rss, m.rss);
+        traces.append(m.trace);
+    }
+    // The compiler total is only known if it was reported for every translation unit
+    if (!traces.contains(-1))
+        total.trace = std::accumulate(traces.begin(), traces.end(), 0.);
+
+    qDebug("wall %.2f s, peak rss %.0f MB, compiler total %.2f s", total.wall, total.rss, total.trace);
+    QTest::setBenchmarkResult(total.wall * 1000, QTest::WalltimeMilliseconds);
+
+    const QString results = environment("VERDIGRIS_BENCH_RESULTS");
+    if (!results.isEmpty()) {
+        QFile file(results);
+        if (file.open(QIODevice::Append | QIODevice::Text)) {
+            if (file.size() == 0)
+                file.write("axis,size,compiler,standard,wall,rss,trace\n");
+            file.write(QStringLiteral("%1,%2,%3,c++%4,%5,%6,%7\n").arg(axis).arg(size)
+                       .arg(QFileInfo(compiler).fileName(), standard).arg(total.wall).arg(total.rss)
+                       .arg(total.trace).toUtf8());
+        }
+    }
+
+    const QString key = QStringLiteral("%1/%2/%3/c++%4").arg(axis).arg(size).arg(QFileInfo(compiler).fileName(), standard);
+    QJsonObject newBudget{ { QLatin1String("wall"), qCeil(total.wall * 1.5 * 10) / 10. },
+                           { QLatin1String("rss"), qCeil(total.rss * 1.5) } };
+    if (total.trace >= 0)
+        newBudget.insert(QLatin1String("trace"), qCeil(total.trace * 1.5 * 10) / 10.);
+    m_newBudgets.insert(key, newBudget);
+
+    const QJsonObject b = budget(axis, size, QFileInfo(compiler).fileName(), standard);
+    const auto check = [&](const char *name, double value, const char *unit) {
+        const QJsonValue limit = b.value(QLatin1String(name));
+        if (limit.isUndefined() || value < 0)
+            return true;
+        const double max = limit.toDouble() * m_budgetFactor;
+        if (value <= max)
+            return true;
+        qWarning("%s: %s is %.2f %s, over the budget of %.2f %s", qPrintable(key), name, value, unit, max, unit);
+        return false;
+    };
+    // Check all of them before failing, so that every regression is reported
+    const bool wallOk = check("wall", total.wall, "s");
+    const bool rssOk = check("rss", total.rss, "MB");
+    const bool traceOk = check("trace", total.trace, "s");
+    QVERIFY2(wallOk && rssOk && traceOk, "Budget exceeded");
+}
+
+/// Run the compiler, with its output in logFile, and measure its wall time and peak memory.
+/// Returns true if the compilation succeeded.
+bool CompileScalingBenchmark::run(const QStringList &arguments, const QString &logFile, Measure &measure)
+{
+#ifdef Q_OS_UNIX
+    QVector<QByteArray> args;
+    for (const QString &a : arguments)
+        args.append(QFile::encodeName(a));
+    QVector<char *> argv;
+    for (QByteArray &a : args)
+        argv.append(a.data());
+    argv.append(nullptr);
+
+    // QProcess does not give the resource usage of the child, so spawn and wait for it directly
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    const QByteArray log = QFile::encodeName(logFile);
+    posix_spawn_file_actions_addopen(&actions, 1, log.constData(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&actions, 1, 2);
+
+    QElapsedTimer timer;
+    timer.start();
+    pid_t pid;
+    const int error = posix_spawnp(&pid, argv.at(0), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0)
+        return false;
+    int status = 0;
+    struct rusage usage = {};
+    while (wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR)
+            return false;
+    }
+    measure.wall = timer.nsecsElapsed() / 1e9;
+#ifdef Q_OS_DARWIN
+    measure.rss = usage.ru_maxrss / (1024. * 1024.); // bytes
+#else
+    measure.rss = usage.ru_maxrss / 1024.; // kilobytes
+#endif
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+    Q_UNUSED(arguments) Q_UNUSED(logFile) Q_UNUSED(measure)
+    return false;
+#endif
+}
+
+/// Whether the compiler accepts -std=c++<standard>, so that older compilers skip the newer standards
+/// instead of failing. The result is cached for each compiler and standard.
+bool CompileScalingBenchmark::supportsStandard(const QString &compiler, const QString &standard)
+{
+    const QString key = compiler + QLatin1String("/c++") + standard;
+    const auto it = m_supportedStandards.constFind(key);
+    if (it != m_supportedStandards.constEnd())
+        return *it;
+
+    QTemporaryDir dir;
+    QFile file(dir.filePath(QStringLiteral("probe.cpp")));
+    bool supported = dir.isValid() && file.open(QIODevice::WriteOnly) && file.write("int probe;\n") > 0;
+    file.close();
+    Measure measure;
+    supported = supported && run({ compiler, QLatin1String("-std=c++") + standard, QStringLiteral("-fsyntax-only"),
+                                   file.fileName() }, dir.filePath(QStringLiteral("probe.log")), measure);
+    m_supportedStandards.insert(key, supported);
+    return supported;
+}
+
+/// The budget of the row, from the most specific key to the least specific one
+QJsonObject CompileScalingBenchmark::budget(const QString &axis, int size, const QString &compiler,
+                                            const QString &standard) const
+{
+    const QString base = axis + QLatin1Char('/') + QString::number(size);
+    for (const QString &key : { base + QLatin1Char('/') + compiler + QLatin1String("/c++") + standard,
+                                base + QLatin1Char('/') + compiler, base }) {
+        const QJsonValue v = m_budgets.value(key);
+        if (v.isObject())
+            return v.toObject();
+    }
+    return {};
+}
+
+QTEST_MAIN(CompileScalingBenchmark)
+
+#include "main.moc"
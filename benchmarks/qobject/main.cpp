@@ -28,8 +28,15 @@
 #include <QtCore>
 #include <qtest.h>
 #include "object.h"
+#include "wobjectqueued.h"
+#include <thread>
+#include <chrono>
+#include "manymethods.h"
 #include <qcoreapplication.h>
 #include <qdatetime.h>
+#ifdef Q_OS_UNIX
+#include <time.h>
+#endif
 
 enum {
     CreationDeletionBenckmarkConstant = 34567,
@@ -45,6 +52,33 @@ private slots:
 
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
+
+    void payload_benchmark_data();
+    void payload_benchmark();
+
+    void queued_benchmark_data();
+    void queued_benchmark();
+
+    void compressed_benchmark_data();
+    void compressed_benchmark();
+
+    void compressed_rate_benchmark_data();
+    void compressed_rate_benchmark();
+
+    void property_benchmark_data();
+    void property_benchmark();
+
+    void invoke_benchmark_data();
+    void invoke_benchmark();
+
+    void invoke_hierarchy_benchmark_data();
+    void invoke_hierarchy_benchmark();
+
+    void name_lookup_benchmark_data();
+    void name_lookup_benchmark();
+
+    void qt_metacast_benchmark_data();
+    void qt_metacast_benchmark();
 };
 
 struct Functor {
@@ -61,6 +95,7 @@ void QObjectBenchmark::signal_slot_benchmark_data()
     QTest::newRow("unconnected signal") << 3 << false;
     QTest::newRow("single signal/ptr") << 4  << false;
     QTest::newRow("functor") << 5            << false;
+    QTest::newRow("blocked signal") << 7     << false;
 
     QTest::newRow("w simple function") << 0    << true;
     QTest::newRow("w single signal/slot") << 1 << true;
@@ -68,9 +103,19 @@ void QObjectBenchmark::signal_slot_benchmark_data()
     QTest::newRow("w unconnected signal") << 3 << true;
     QTest::newRow("w single signal/ptr") << 4  << true;
     QTest::newRow("w functor") << 5            << true;
+    QTest::newRow("w w_connect") << 6          << true;
+    QTest::newRow("w blocked signal") << 7     << true;
 
 }
 
+// w_connect only exists for Verdigris objects
+static void connectByIndex(Object *) {}
+static void connectByIndex(ObjectW *obj)
+{
+    w_connect<decltype(&ObjectW::signal0), &ObjectW::signal0,
+              decltype(&ObjectW::slot0), &ObjectW::slot0>(obj, obj);
+}
+
 template<typename Object>
 void signal_slot_benchmark()
 {
@@ -82,7 +127,9 @@ void signal_slot_benchmark()
     singleObject.setObjectName("single");
     multiObject.setObjectName("multi");
 
-    if (type == 5) {
+    if (type == 6) {
+        connectByIndex(&singleObject);
+    } else if (type == 5) {
         QObject::connect(&singleObject, &Object::signal0, functor);
     } else if (type == 4) {
         QObject::connect(&singleObject, &Object::signal0, &singleObject, &Object::slot0);
@@ -126,7 +173,12 @@ void signal_slot_benchmark()
         QBENCHMARK {
             singleObject.emitSignal1();
         }
-    } else if (type == 4 || type == 5) {
+    } else if (type == 4 || type == 5 || type == 6) {
+        QBENCHMARK {
+            singleObject.emitSignal0();
+        }
+    } else if (type == 7) {
+        singleObject.blockSignals(true);
         QBENCHMARK {
             singleObject.emitSignal0();
         }
@@ -160,6 +212,7 @@ void QObjectBenchmark::connect_disconnect_benchmark_data()
     QTest::newRow("w unormalized signature/handle") << 4  << true;
     QTest::newRow("w function pointer/handle") << 5       << true;
     QTest::newRow("w functor/handle") << 6                << true;
+    QTest::newRow("w w_connect/handle") << 7              << true;
 
 }
 
@@ -220,10 +273,377 @@ void connect_disconnect_benchmark()
 void QObjectBenchmark::connect_disconnect_benchmark()
 {
     QFETCH(bool, w);
+    QFETCH(int, type);
+    if (type == 7) {
+        // The indexes are computed at compile time, so this only exists for Verdigris objects
+        ObjectW obj;
+        QBENCHMARK {
+            QObject::disconnect(w_connect<decltype(&ObjectW::signal5), &ObjectW::signal5,
+                                          decltype(&ObjectW::slot5), &ObjectW::slot5>(&obj, &obj));
+        }
+        return;
+    }
     if (w) ::connect_disconnect_benchmark<ObjectW>();
     else ::connect_disconnect_benchmark<Object>();
 }
 
+void QObjectBenchmark::payload_benchmark_data()
+{
+    QTest::addColumn<bool>("map");
+    QTest::addColumn<bool>("w");
+    QTest::newRow("QByteArray") << false << false;
+    QTest::newRow("QVariantMap") << true << false;
+
+    QTest::newRow("w QByteArray") << false << true;
+    QTest::newRow("w QVariantMap") << true << true;
+}
+
+template<typename Object, typename Payload, typename Signal, typename Slot>
+void payload_benchmark(const Payload &payload, Signal signal, Slot slot)
+{
+    Object obj;
+    QObject::connect(&obj, signal, &obj, slot);
+    QBENCHMARK {
+        (obj.*signal)(payload);
+    }
+    // The parameter of the signal holds the only reference to a moved payload, so the slot
+    // sees a detached payload only if the signal did not copy it again.
+    Payload moved = payload;
+    moved.detach();
+    (obj.*signal)(std::move(moved));
+    QVERIFY(obj.lastDetached);
+}
+
+void QObjectBenchmark::payload_benchmark()
+{
+    QFETCH(bool, map);
+    QFETCH(bool, w);
+    QByteArray bytes(1024 * 1024, 'x');
+    QVariantMap variantMap;
+    for (int i = 0; i < 100; ++i)
+        variantMap.insert(QString::number(i), bytes);
+    if (w) {
+        if (map) ::payload_benchmark<PayloadObjectW>(variantMap, &PayloadObjectW::mapSignal, &PayloadObjectW::mapSlot);
+        else ::payload_benchmark<PayloadObjectW>(bytes, &PayloadObjectW::bytesSignal, &PayloadObjectW::bytesSlot);
+    } else {
+        if (map) ::payload_benchmark<PayloadObject>(variantMap, &PayloadObject::mapSignal, &PayloadObject::mapSlot);
+        else ::payload_benchmark<PayloadObject>(bytes, &PayloadObject::bytesSignal, &PayloadObject::bytesSlot);
+    }
+}
+
+void QObjectBenchmark::queued_benchmark_data()
+{
+    QTest::addColumn<bool>("w");
+    QTest::newRow("Qt::QueuedConnection") << false;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    QTest::newRow("w_connectQueued") << true;
+#endif
+}
+
+void QObjectBenchmark::queued_benchmark()
+{
+    QFETCH(bool, w);
+    PayloadObjectW sender;
+    PayloadObjectW receiver;
+    if (w) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+        w_connectQueued<decltype(&PayloadObjectW::bytesSignal), &PayloadObjectW::bytesSignal,
+                        decltype(&PayloadObjectW::bytesSlot), &PayloadObjectW::bytesSlot>(&sender, &receiver);
+#endif
+    } else {
+        QObject::connect(&sender, &PayloadObjectW::bytesSignal, &receiver, &PayloadObjectW::bytesSlot,
+                         Qt::QueuedConnection);
+    }
+    // Emit from another thread, while this thread delivers the calls. A burst smaller than the
+    // initial capacity of the w_connectQueued queue, so it measures the queue and not its growth.
+    const QByteArray bytes(64, 'x');
+    const int count = 1000;
+    QBENCHMARK {
+        receiver.received = 0;
+        std::thread producer([&] {
+            for (int i = 0; i < count; ++i)
+                emit sender.bytesSignal(bytes);
+        });
+        while (receiver.received < count)
+            QCoreApplication::processEvents();
+        producer.join();
+    }
+}
+
+void QObjectBenchmark::compressed_benchmark_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::newRow("Qt::QueuedConnection") << 0;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    QTest::newRow("w_connectQueued") << 1;
+    QTest::newRow("W_Compressed") << 2;
+#endif
+}
+
+// 0: Qt::QueuedConnection, 1: w_connectQueued, 2: w_connectQueued to a W_Compressed signal
+static void connectProgress(int type, ProgressObjectW *sender, ProgressObjectW *receiver)
+{
+    if (type == 0) {
+        QObject::connect(sender, &ProgressObjectW::compressedProgress, receiver, &ProgressObjectW::setProgress,
+                         Qt::QueuedConnection);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    } else if (type == 1) {
+        w_connectQueued<decltype(&ProgressObjectW::progress), &ProgressObjectW::progress,
+                        decltype(&ProgressObjectW::setProgress), &ProgressObjectW::setProgress>(sender, receiver);
+    } else {
+        w_connectQueued<decltype(&ProgressObjectW::compressedProgress), &ProgressObjectW::compressedProgress,
+                        decltype(&ProgressObjectW::setProgress), &ProgressObjectW::setProgress>(sender, receiver);
+#endif
+    }
+}
+
+static void emitProgress(int type, ProgressObjectW *sender, int value)
+{
+    if (type == 1)
+        emit sender->progress(value);
+    else
+        emit sender->compressedProgress(value);
+}
+
+void QObjectBenchmark::compressed_benchmark()
+{
+    QFETCH(int, type);
+    // What a 100 kHz producer emits in 100 ms, between two iterations of the receiver's event loop
+    const int count = 10000;
+    ProgressObjectW sender;
+    ProgressObjectW receiver;
+    connectProgress(type, &sender, &receiver);
+    QBENCHMARK {
+        receiver.received = 0;
+        for (int i = 0; i < count; ++i)
+            emitProgress(type, &sender, i);
+        QCoreApplication::processEvents();
+    }
+    // The amount of calls that were pending in the receiver's event queue
+    QCOMPARE(receiver.received, type == 2 ? 1 : count);
+    QCOMPARE(receiver.lastValue, count - 1);
+}
+
+void QObjectBenchmark::compressed_rate_benchmark_data()
+{
+    compressed_benchmark_data();
+}
+
+static qint64 threadCpuTime()
+{
+#ifdef Q_OS_UNIX
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+void QObjectBenchmark::compressed_rate_benchmark()
+{
+    QFETCH(int, type);
+    // Another thread emits at 100 kHz for 500 ms, while this thread runs its event loop at 60 Hz
+    // like a GUI thread. The result is the largest amount of calls delivered by one iteration of
+    // the event loop, which is the length the event queue reached. The CPU time spent by this
+    // thread in the event loop is printed (only measured on Unix).
+    const std::chrono::nanoseconds period(10000);
+    const std::chrono::milliseconds duration(500);
+    ProgressObjectW sender;
+    ProgressObjectW receiver;
+    connectProgress(type, &sender, &receiver);
+    QAtomicInt emitted;
+    QAtomicInt done;
+    std::thread producer([&] {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; period * i < duration; ++i) {
+            while (std::chrono::steady_clock::now() < start + period * i) {}
+            emitProgress(type, &sender, i);
+            emitted.storeRelease(i + 1);
+        }
+        done.storeRelease(1);
+    });
+    int longestQueue = 0;
+    qint64 cpuTime = 0;
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        const bool finished = done.loadAcquire();
+        const int before = receiver.received;
+        const qint64 cpuBefore = threadCpuTime();
+        QCoreApplication::processEvents();
+        cpuTime += threadCpuTime() - cpuBefore;
+        longestQueue = qMax(longestQueue, receiver.received - before);
+        if (finished && receiver.lastValue == emitted.loadAcquire() - 1)
+            break;
+    }
+    producer.join();
+    qDebug("%d emissions, %d calls, event loop CPU time: %.1f ms", emitted.loadAcquire(), receiver.received,
+           cpuTime / 1e6);
+    QTest::setBenchmarkResult(longestQueue, QTest::Events);
+}
+
+void QObjectBenchmark::property_benchmark_data()
+{
+    QTest::addColumn<bool>("typed");
+    QTest::newRow("QMetaProperty::read") << false;
+    QTest::newRow("w_property::get") << true;
+}
+
+void QObjectBenchmark::property_benchmark()
+{
+    QFETCH(bool, typed);
+    ProgressObjectW obj;
+    obj.lastValue = 42;
+    const QMetaProperty property = obj.metaObject()->property(obj.metaObject()->indexOfProperty("lastValue"));
+    using LastValue = w_property<ProgressObjectW, w_indexOfProperty<ProgressObjectW>("lastValue").relative>;
+    int sum = 0;
+    if (typed) {
+        QBENCHMARK {
+            for (int i = 0; i < 1000; ++i)
+                sum += LastValue::get(&obj);
+        }
+    } else {
+        QBENCHMARK {
+            for (int i = 0; i < 1000; ++i)
+                sum += property.read(&obj).toInt();
+        }
+    }
+    QVERIFY(sum % 42 == 0);
+}
+
+void QObjectBenchmark::invoke_benchmark_data()
+{
+    QTest::addColumn<int>("methods");
+    QTest::newRow("w 10 methods") << 10;
+    QTest::newRow("w 100 methods") << 100;
+    QTest::newRow("w 1000 methods") << 1000;
+}
+
+template<typename Object>
+void invoke_benchmark()
+{
+    Object obj;
+    // Call the last slot, which was the worst case when the dispatch was a linear search
+    const int index = obj.metaObject()->methodCount() - 1;
+    int arg = 42;
+    void *argv[] = { nullptr, &arg };
+    QBENCHMARK {
+        QMetaObject::metacall(&obj, QMetaObject::InvokeMetaMethod, index, argv);
+    }
+    QCOMPARE(obj.value, 42);
+}
+
+void QObjectBenchmark::invoke_benchmark()
+{
+    QFETCH(int, methods);
+    switch (methods) {
+        case 10: ::invoke_benchmark<ManyMethods10>(); break;
+        case 100: ::invoke_benchmark<ManyMethods100>(); break;
+        case 1000: ::invoke_benchmark<ManyMethods1000>(); break;
+    }
+}
+
+void QObjectBenchmark::invoke_hierarchy_benchmark_data()
+{
+    QTest::addColumn<QByteArray>("method");
+    QTest::newRow("w method of the most derived class") << QByteArray("level5Slot(int)");
+    QTest::newRow("w method of the middle class") << QByteArray("level3Slot(int)");
+    QTest::newRow("w method of the base class") << QByteArray("level1Slot(int)");
+}
+
+void QObjectBenchmark::invoke_hierarchy_benchmark()
+{
+    QFETCH(QByteArray, method);
+    DeepLevel5 obj;
+    const int index = obj.metaObject()->indexOfMethod(method.constData());
+    QVERIFY(index >= 0);
+    int arg = 42;
+    void *argv[] = { nullptr, &arg };
+    QBENCHMARK {
+        QMetaObject::metacall(&obj, QMetaObject::InvokeMetaMethod, index, argv);
+    }
+    QCOMPARE(obj.value, 42);
+}
+
+void QObjectBenchmark::name_lookup_benchmark_data()
+{
+    QTest::addColumn<int>("methods");
+    QTest::addColumn<bool>("w");
+    QTest::newRow("indexOfMethod 10 methods") << 10 << false;
+    QTest::newRow("indexOfMethod 100 methods") << 100 << false;
+    QTest::newRow("indexOfMethod 1000 methods") << 1000 << false;
+    QTest::newRow("indexOfMethod base class") << 0 << false;
+    QTest::newRow("w_indexOfMethod 10 methods") << 10 << true;
+    QTest::newRow("w_indexOfMethod 100 methods") << 100 << true;
+    QTest::newRow("w_indexOfMethod 1000 methods") << 1000 << true;
+    QTest::newRow("w_indexOfMethod base class") << 0 << true;
+}
+
+template<typename Object>
+void name_lookup_benchmark(const char *signature, bool w)
+{
+    const int expected = Object::staticMetaObject.indexOfMethod(signature);
+    QVERIFY(expected >= 0);
+    int index = -1;
+    if (w) {
+        QBENCHMARK {
+            index = wIndexOfMethod<Object>(signature);
+        }
+    } else {
+        QBENCHMARK {
+            index = Object::staticMetaObject.indexOfMethod(signature);
+        }
+    }
+    QCOMPARE(index, expected);
+}
+
+void QObjectBenchmark::name_lookup_benchmark()
+{
+    QFETCH(int, methods);
+    QFETCH(bool, w);
+    // The last slot, which is the worst case for a linear search
+    switch (methods) {
+        case 10: ::name_lookup_benchmark<ManyMethods10>("slot9(int)", w); break;
+        case 100: ::name_lookup_benchmark<ManyMethods100>("slot99(int)", w); break;
+        case 1000: ::name_lookup_benchmark<ManyMethods1000>("slot999(int)", w); break;
+        case 0: ::name_lookup_benchmark<DeepLevel5>("level1Slot(int)", w); break;
+    }
+}
+
+void QObjectBenchmark::qt_metacast_benchmark_data()
+{
+    QTest::addColumn<QByteArray>("name");
+    QTest::addColumn<bool>("w");
+    QTest::newRow("class name") << QByteArray("CastObject") << false;
+    QTest::newRow("QObject") << QByteArray("QObject") << false;
+    QTest::newRow("interface") << QByteArray("org.verdigris.BenchInterface") << false;
+    QTest::newRow("unknown") << QByteArray("org.verdigris.UnknownInterface") << false;
+
+    QTest::newRow("w class name") << QByteArray("CastObjectW") << true;
+    QTest::newRow("w QObject") << QByteArray("QObject") << true;
+    QTest::newRow("w interface") << QByteArray("org.verdigris.BenchInterface") << true;
+    QTest::newRow("w unknown") << QByteArray("org.verdigris.UnknownInterface") << true;
+}
+
+template<typename Object>
+void qt_metacast_benchmark(const char *name)
+{
+    Object obj;
+    void *result = nullptr;
+    QBENCHMARK {
+        result = obj.qt_metacast(name);
+    }
+    Q_UNUSED(result);
+}
+
+void QObjectBenchmark::qt_metacast_benchmark()
+{
+    QFETCH(QByteArray, name);
+    QFETCH(bool, w);
+    if (w) ::qt_metacast_benchmark<CastObjectW>(name.constData());
+    else ::qt_metacast_benchmark<CastObject>(name.constData());
+}
+
 QTEST_MAIN(QObjectBenchmark)
 
 #include "main.moc"
\ No newline at end of file
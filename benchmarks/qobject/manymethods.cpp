@@ -0,0 +1,40 @@
+/****************************************************************************
+ *  Copyright (C) 2016-2018 Woboq GmbH
+ *  Olivier Goffart <ogoffart at woboq.com>
+ *  https://woboq.com/
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "manymethods.h"
+#include "wobjectimpl.h"
+
+W_OBJECT_IMPL(ManyMethods10)
+W_OBJECT_IMPL(ManyMethods100)
+W_OBJECT_IMPL(ManyMethods1000)
+
+W_OBJECT_IMPL(DeepLevel1)
+W_OBJECT_IMPL(DeepLevel2)
+W_OBJECT_IMPL(DeepLevel3)
+W_OBJECT_IMPL(DeepLevel4)
+W_OBJECT_IMPL(DeepLevel5)
+
+template<typename T> int wIndexOfMethod(const char *signature)
+{
+    return w_indexOfMethod<T>(signature);
+}
+template int wIndexOfMethod<ManyMethods10>(const char *);
+template int wIndexOfMethod<ManyMethods100>(const char *);
+template int wIndexOfMethod<ManyMethods1000>(const char *);
+template int wIndexOfMethod<DeepLevel5>(const char *);
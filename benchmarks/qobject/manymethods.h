@@ -0,0 +1,94 @@
+/****************************************************************************
+ *  Copyright (C) 2016-2018 Woboq GmbH
+ *  Olivier Goffart <ogoffart at woboq.com>
+ *  https://woboq.com/
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MANYMETHODS_H
+#define MANYMETHODS_H
+
+#include <qobject.h>
+#include "wobjectdefs.h"
+
+// Classes with 10, 100 and 1000 slots, to check that the cost of calling a method through
+// the meta object system does not depend on the amount of methods.
+
+#define MANY_REPEAT10(M, P) M(P##0) M(P##1) M(P##2) M(P##3) M(P##4) \
+                            M(P##5) M(P##6) M(P##7) M(P##8) M(P##9)
+#define MANY_REPEAT100(M, P) MANY_REPEAT10(M, P##0) MANY_REPEAT10(M, P##1) MANY_REPEAT10(M, P##2) \
+                             MANY_REPEAT10(M, P##3) MANY_REPEAT10(M, P##4) MANY_REPEAT10(M, P##5) \
+                             MANY_REPEAT10(M, P##6) MANY_REPEAT10(M, P##7) MANY_REPEAT10(M, P##8) \
+                             MANY_REPEAT10(M, P##9)
+#define MANY_REPEAT1000(M) MANY_REPEAT100(M, 0) MANY_REPEAT100(M, 1) MANY_REPEAT100(M, 2) \
+                           MANY_REPEAT100(M, 3) MANY_REPEAT100(M, 4) MANY_REPEAT100(M, 5) \
+                           MANY_REPEAT100(M, 6) MANY_REPEAT100(M, 7) MANY_REPEAT100(M, 8) \
+                           MANY_REPEAT100(M, 9)
+
+#define MANY_DECLARE_SLOT(N) void slot##N(int v) { value = v; } W_SLOT(slot##N)
+
+class ManyMethods10 : public QObject
+{
+    W_OBJECT(ManyMethods10)
+public:
+    int value = 0;
+    MANY_REPEAT10(MANY_DECLARE_SLOT, )
+};
+
+class ManyMethods100 : public QObject
+{
+    W_OBJECT(ManyMethods100)
+public:
+    int value = 0;
+    MANY_REPEAT100(MANY_DECLARE_SLOT, )
+};
+
+class ManyMethods1000 : public QObject
+{
+    W_OBJECT(ManyMethods1000)
+public:
+    int value = 0;
+    MANY_REPEAT1000(MANY_DECLARE_SLOT)
+};
+
+// A hierarchy of five Verdigris classes, to check the cost of calling a method through
+// qt_metacall when the method is owned by a base class.
+
+#define DEEP_DECLARE_LEVEL(N, BASE) \
+class DeepLevel##N : public BASE \
+{ \
+    W_OBJECT(DeepLevel##N) \
+public: \
+    void level##N##Slot(int v) { value = v; } \
+    W_SLOT(level##N##Slot) \
+};
+
+class DeepLevel1 : public QObject
+{
+    W_OBJECT(DeepLevel1)
+public:
+    int value = 0;
+    void level1Slot(int v) { value = v; }
+    W_SLOT(level1Slot)
+};
+DEEP_DECLARE_LEVEL(2, DeepLevel1)
+DEEP_DECLARE_LEVEL(3, DeepLevel2)
+DEEP_DECLARE_LEVEL(4, DeepLevel3)
+DEEP_DECLARE_LEVEL(5, DeepLevel4)
+
+// w_indexOfMethod<T>(signature), instantiated in manymethods.cpp
+template<typename T> int wIndexOfMethod(const char *signature);
+
+#endif // MANYMETHODS_H
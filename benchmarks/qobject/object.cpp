@@ -83,3 +83,6 @@ void ObjectW::slot9()
 { }
 
 W_OBJECT_IMPL(ObjectW)
+W_OBJECT_IMPL(PayloadObjectW)
+W_OBJECT_IMPL(ProgressObjectW)
+W_OBJECT_IMPL(CastObjectW)
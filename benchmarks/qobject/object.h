@@ -29,6 +29,7 @@
 #define OBJECT_H
 
 #include <qobject.h>
+#include <qvariant.h>
 #include "wobjectimpl.h"
 
 class Object : public QObject
@@ -93,5 +94,81 @@ public:
 
 };
 
+// Signals with parameters declared by value, to check that the payload is not copied again when
+// emitting. The slots record if the payload they receive is shared with another object.
+class PayloadObject : public QObject
+{
+    Q_OBJECT
+public:
+    bool lastDetached = false;
+    int received = 0;
+signals:
+    void bytesSignal(QByteArray data);
+    void mapSignal(QVariantMap data);
+public slots:
+    void bytesSlot(const QByteArray &data) { lastDetached = data.isDetached(); ++received; }
+    void mapSlot(const QVariantMap &data) { lastDetached = data.isDetached(); }
+};
+
+class PayloadObjectW : public QObject
+{
+    W_OBJECT(PayloadObjectW)
+public:
+    bool lastDetached = false;
+    int received = 0;
+//signals:
+    void bytesSignal(QByteArray data) W_SIGNAL(bytesSignal, data)
+    void mapSignal(QVariantMap data) W_SIGNAL(mapSignal, data)
+
+//public slots:
+    void bytesSlot(const QByteArray &data) { lastDetached = data.isDetached(); ++received; }
+    W_SLOT(bytesSlot)
+    void mapSlot(const QVariantMap &data) { lastDetached = data.isDetached(); }
+    W_SLOT(mapSlot)
+};
+
+class ProgressObjectW : public QObject
+{
+    W_OBJECT(ProgressObjectW)
+public:
+    int received = 0;
+    int lastValue = -1;
+//signals:
+    void progress(int value) W_SIGNAL(progress, value)
+    void compressedProgress(int value) W_SIGNAL(compressedProgress, value, W_Compressed)
+
+//public slots:
+    void setProgress(int value) { lastValue = value; ++received; }
+    W_SLOT(setProgress)
+
+    W_PROPERTY(int, lastValue MEMBER lastValue)
+};
+
+class BenchInterface
+{
+public:
+    virtual ~BenchInterface() {}
+};
+Q_DECLARE_INTERFACE(BenchInterface, "org.verdigris.BenchInterface")
+
+class OtherBenchInterface
+{
+public:
+    virtual ~OtherBenchInterface() {}
+};
+Q_DECLARE_INTERFACE(OtherBenchInterface, "org.verdigris.OtherBenchInterface")
+
+class CastObject : public QObject, public OtherBenchInterface, public BenchInterface
+{
+    Q_OBJECT
+    Q_INTERFACES(OtherBenchInterface BenchInterface)
+};
+
+class CastObjectW : public QObject, public OtherBenchInterface, public BenchInterface
+{
+    W_OBJECT(CastObjectW)
+    W_INTERFACE(OtherBenchInterface)
+    W_INTERFACE(BenchInterface)
+};
 
 #endif // OBJECT_H
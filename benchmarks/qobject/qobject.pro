@@ -3,7 +3,7 @@ QT = core testlib
 TEMPLATE = app
 TARGET = tst_bench_qobject
 
-HEADERS += object.h
-SOURCES += main.cpp object.cpp
+HEADERS += object.h manymethods.h
+SOURCES += main.cpp object.cpp manymethods.cpp
 
 include(../../src/verdigris.pri)
@@ -168,7 +168,7 @@ constexpr auto makeFlagInfo(StringView name, StringView enumAliasName, w_interna
 ///
 /// \note you have to ensure that the struct is only valid for some `I`s.
 #define W_CPP_PROPERTY(a) \
-    static constexpr size_t W_MACRO_CONCAT(a,_O) = w_internal::stateCount<__COUNTER__, w_internal::PropertyStateTag, W_ThisType**>; \
+    static constexpr size_t W_MACRO_CONCAT(a,_O) = w_internal::boundedStateCount<__COUNTER__, W_ThisType::W_CounterStart, w_internal::PropertyStateTag, W_ThisType**>; \
     template<size_t I> \
     friend constexpr auto w_state(w_internal::Index<I>, w_internal::PropertyStateTag, W_ThisType**) W_RETURN((a<I-W_MACRO_CONCAT(a,_O)>::property))
 
@@ -186,7 +186,7 @@ constexpr auto makeFlagInfo(StringView name, StringView enumAliasName, w_interna
 ///
 /// \note you have to ensure that the struct is only valid for some `I`s.
 #define W_CPP_SIGNAL(a) \
-    static constexpr size_t W_MACRO_CONCAT(a,_O) = w_internal::stateCount<__COUNTER__, w_internal::SignalStateTag, W_ThisType**>; \
+    static constexpr size_t W_MACRO_CONCAT(a,_O) = w_internal::boundedStateCount<__COUNTER__, W_ThisType::W_CounterStart, w_internal::SignalStateTag, W_ThisType**>; \
     template<size_t I> \
     friend constexpr auto w_state(w_internal::Index<I>, w_internal::SignalStateTag, W_ThisType**) W_RETURN((a<I-W_MACRO_CONCAT(a,_O)>::signal))
 
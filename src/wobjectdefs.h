@@ -283,11 +283,18 @@ namespace W_MethodType {
 //    MethodRevisioned = 0x80
 constexpr w_internal::W_MethodFlags<0x10> W_Compat{};
 constexpr w_internal::W_MethodFlags<0x40> W_Scriptable{};
+// Not a Qt flag, it is not written in the meta object. See W_SIGNAL
+// Only the connections made with w_connectQueued (wobjectqueued.h) are compressed: an ordinary
+// Qt::QueuedConnection to the same signal still posts one event per emission.
+constexpr w_internal::W_MethodFlags<0x2000> W_Compressed{};
 constexpr struct {} W_Notify{};
 constexpr struct {} W_Reset{};
 constexpr std::integral_constant<int, int(w_internal::PropertyFlags::Constant)> W_Constant{};
 constexpr std::integral_constant<int, int(w_internal::PropertyFlags::Final)> W_Final{};
 
+/// Designates the object itself as the sender or the receiver in W_CONNECTION
+constexpr struct {} W_This{};
+
 namespace w_internal {
 
 /// Holds information about a method
@@ -323,6 +330,21 @@ makeMetaSignalInfo(F f, StringView name, IntegralConstant, const ParamTypes &par
                     const ParamNames &paramNames, W_MethodFlags<Flags>...)
 { return { f, name, paramTypes, paramNames }; }
 
+/// Holds information about a connection declared with W_CONNECTION.
+/// Sender and Receiver are the type of W_This or pointers to data members;
+/// SignalIC and SlotIC are std::integral_constant holding the pointers to member functions.
+template<typename Sender, typename SignalIC, typename Receiver, typename SlotIC>
+struct MetaConnectionInfo {
+    Sender sender;
+    Receiver receiver;
+};
+
+// Called from the W_CONNECTION macro
+template<typename Sender, typename SignalIC, typename Receiver, typename SlotIC>
+constexpr MetaConnectionInfo<Sender, SignalIC, Receiver, SlotIC>
+makeMetaConnectionInfo(Sender sender, SignalIC, Receiver receiver, SlotIC)
+{ return { sender, receiver }; }
+
 /// Holds information about a constructor
 template<typename... Args>
 struct MetaConstructorInfo {
@@ -399,6 +421,15 @@ template <typename PropInfo, typename Obj, typename Arg, typename Ret, typename.
 constexpr auto parseProperty(const PropInfo &p, Ret (Obj::*s)(Arg) noexcept, Tail... t)
 { return parseProperty(p.setSetter(s) , t...); }
 #endif
+/// Whether the setter S takes its argument by value or by rvalue reference, in which case the
+/// value written with WriteProperty can be moved into it
+template <typename S> struct SetterTakesRvalue : std::false_type {};
+template <typename Obj, typename Arg, typename Ret>
+struct SetterTakesRvalue<Ret (Obj::*)(Arg)> : std::integral_constant<bool, !std::is_lvalue_reference<Arg>::value> {};
+#if defined(__cpp_noexcept_function_type) && __cpp_noexcept_function_type >= 201510
+template <typename Obj, typename Arg, typename Ret>
+struct SetterTakesRvalue<Ret (Obj::*)(Arg) noexcept> : SetterTakesRvalue<Ret (Obj::*)(Arg)> {};
+#endif
 // getter
 template <typename PropInfo, typename Obj, typename Ret, typename... Tail>
 constexpr auto parseProperty(const PropInfo &p, Ret (Obj::*s)(), Tail... t)
@@ -486,6 +517,20 @@ template<int N> constexpr int removedScopeSize(const char (&name)[N]) {
     return N - p;
 }
 
+/// What can follow the arguments of a signal in the call made by W_SIGNAL: the flags given after
+/// the parameter names, then the 0 added by the macro.
+template<typename T> struct IsSignalTail : std::is_same<T, int> {};
+template<> struct IsSignalTail<std::decay_t<decltype(W_Compressed)>> : std::true_type {};
+template<typename... Tail>
+constexpr bool areSignalTail() { return sums(int(IsSignalTail<Tail>::value)...) == int(sizeof...(Tail)); }
+/// The flags given by the types of the tail
+template<typename... Tail>
+constexpr int signalTailFlags() {
+    return sums((std::is_same<Tail, std::decay_t<decltype(W_Compressed)>>::value ? W_Compressed.value : 0)...);
+}
+
+template<typename T, int I> struct SignalFlags;
+
 /// Helper for the implementation of a signal.
 /// Called from the signal implementation within the W_SIGNAL macro.
 ///
@@ -496,12 +541,39 @@ template<int N> constexpr int removedScopeSize(const char (&name)[N]) {
 /// There is specialization for const and non-const,  and for void and non-void signals.
 ///
 /// the last argument of the operator() is an int, to workaround the ",0" required in the W_SIGNAL
-/// macro to make sure there is at least one argument for the ...
+/// macro to make sure there is at least one argument for the ... It can be preceded by the flags
+/// given to W_SIGNAL (see IsSignalTail). Their types are checked against the flags recorded in the
+/// state of the signal, which could only find them in the parameter names as text.
+///
+/// The arguments are taken by reference whatever their declared form, so the addresses of the
+/// parameters of the signal are put in the array of arguments without any copy, like moc does.
+///
+/// QMetaObject::activate does nothing when the signals are blocked, so signalsBlocked() is
+/// checked inline before building the array of arguments. That is the only inline check.
+/// Whether the signal is connected is not checked here: the connections are in QObjectPrivate,
+/// and the only public check, QObject::isSignalConnected, is protected and computes the index of
+/// the signal out of line. That costs more than the array, which only holds the addresses of the
+/// arguments, and QMetaObject::activate checks the connections before using it. Code that wants
+/// to avoid computing expensive arguments can use w_isConnected.
+///
+/// For non-void signals, the slots assign their result to the object pointed by the first element
+/// of the array of arguments, so that object must exist before the activation. It is only
+/// constructed when the signal can reach a receiver, after the check of the blocked flag. It is
+/// the returned object (a named return value, so it can be elided), and it stays value-initialized
+/// if no slot gives a result. A blocked signal returns a value-initialized temporary.
+/// So, like with moc, the return type must be default constructible: the slots assign to an
+/// existing object, and the signal has to return something when no slot is called.
 template<typename Func, int Idx> struct SignalImplementation {};
 template<typename Obj, typename Ret, typename... Args, int Idx>
 struct SignalImplementation<Ret (Obj::*)(Args...), Idx>{
     Obj *this_;
-    Ret operator()(Args... args, int) const {
+    template<typename... Tail>
+    Ret operator()(const Args &... args, Tail...) const {
+        static_assert(areSignalTail<Tail...>(), "Only flags such as W_Compressed can follow the parameter names of W_SIGNAL");
+        static_assert(signalTailFlags<Tail...>() == (SignalFlags<Obj, Idx>::value & W_Compressed.value),
+                      "The flags recorded for the signal do not match the flags given to W_SIGNAL");
+        if (this_->signalsBlocked())
+            return Ret{};
         Ret r{};
         const void * a[]= { std::addressof(r), std::addressof(args)... };
         QMetaObject::activate(this_, &Obj::staticMetaObject, Idx, const_cast<void **>(a));
@@ -511,7 +583,13 @@ struct SignalImplementation<Ret (Obj::*)(Args...), Idx>{
 template<typename Obj, typename... Args, int Idx>
 struct SignalImplementation<void (Obj::*)(Args...), Idx>{
     Obj *this_;
-    void operator()(Args... args, int) {
+    template<typename... Tail>
+    void operator()(const Args &... args, Tail...) {
+        static_assert(areSignalTail<Tail...>(), "Only flags such as W_Compressed can follow the parameter names of W_SIGNAL");
+        static_assert(signalTailFlags<Tail...>() == (SignalFlags<Obj, Idx>::value & W_Compressed.value),
+                      "The flags recorded for the signal do not match the flags given to W_SIGNAL");
+        if (this_->signalsBlocked())
+            return;
         const void * a[]= { nullptr, std::addressof(args)... };
         QMetaObject::activate(this_, &Obj::staticMetaObject, Idx, const_cast<void **>(a));
     }
@@ -519,7 +597,13 @@ struct SignalImplementation<void (Obj::*)(Args...), Idx>{
 template<typename Obj, typename Ret, typename... Args, int Idx>
 struct SignalImplementation<Ret (Obj::*)(Args...) const, Idx>{
     const Obj *this_;
-    Ret operator()(Args... args, int) const {
+    template<typename... Tail>
+    Ret operator()(const Args &... args, Tail...) const {
+        static_assert(areSignalTail<Tail...>(), "Only flags such as W_Compressed can follow the parameter names of W_SIGNAL");
+        static_assert(signalTailFlags<Tail...>() == (SignalFlags<Obj, Idx>::value & W_Compressed.value),
+                      "The flags recorded for the signal do not match the flags given to W_SIGNAL");
+        if (this_->signalsBlocked())
+            return Ret{};
         Ret r{};
         const void * a[]= { std::addressof(r), std::addressof(args)... };
         QMetaObject::activate(const_cast<Obj*>(this_), &Obj::staticMetaObject, Idx, const_cast<void **>(a));
@@ -529,7 +613,13 @@ struct SignalImplementation<Ret (Obj::*)(Args...) const, Idx>{
 template<typename Obj, typename... Args, int Idx>
 struct SignalImplementation<void (Obj::*)(Args...) const, Idx>{
     const Obj *this_;
-    void operator()(Args... args, int) {
+    template<typename... Tail>
+    void operator()(const Args &... args, Tail...) {
+        static_assert(areSignalTail<Tail...>(), "Only flags such as W_Compressed can follow the parameter names of W_SIGNAL");
+        static_assert(signalTailFlags<Tail...>() == (SignalFlags<Obj, Idx>::value & W_Compressed.value),
+                      "The flags recorded for the signal do not match the flags given to W_SIGNAL");
+        if (this_->signalsBlocked())
+            return;
         const void * a[]= { nullptr, std::addressof(args)... };
         QMetaObject::activate(const_cast<Obj*>(this_), &Obj::staticMetaObject, Idx, const_cast<void **>(a));
     }
@@ -694,6 +784,30 @@ constexpr size_t count() {
 
 template<size_t L, class State, class TPP>
 constexpr auto stateCount = count<L, State, TPP>();
+
+/// boundedStateCount is the same as stateCount, for the W_ macros within a class.
+/// Start is the value of __COUNTER__ at the beginning of the class (W_CounterStart). Each state
+/// entry declared since then used a value of __COUNTER__, so there are less than L - Start entries.
+/// The binary search starts from that bound instead of first doubling an index until there is no
+/// entry. This is still a binary search: it only saves the doubling, so the amount of lookups of
+/// w_state, each of them being an overload resolution among all the entries of the class, goes
+/// from about 2*log2(count) to 1 + log2(L - Start). That is a constant factor, which only shows
+/// for classes with many entries.
+/// W_CPP_PROPERTY and W_CPP_SIGNAL declare several entries at once, so the bound is checked first.
+template<size_t L, size_t Start, class State, class TPP>
+constexpr size_t boundedCount() {
+    constexpr size_t bound = L - Start;
+    using R = decltype(w_state(index<bound>, State{}, TPP{}));
+    if constexpr (std::is_same_v<void, R>) {
+        return countBetween<L, State, TPP, 0, bound>();
+    }
+    else {
+        return count<L, State, TPP, bound ? 2 * bound : 1>();
+    }
+}
+
+template<size_t L, size_t Start, class State, class TPP>
+constexpr auto boundedStateCount = boundedCount<L, Start, State, TPP>();
 #else
 template<size_t L, class State, class TPP
           , size_t N, size_t M, size_t X = (N+M)/2
@@ -734,6 +848,19 @@ struct Count<L, State, TPP, N, false> {
 
 template<size_t L, class State, class TPP>
 constexpr auto stateCount = Count<L, State, TPP>::value;
+
+template<size_t L, size_t Start, class State, class TPP
+          , bool noBound = std::is_same<void, decltype(w_state(index<L - Start>, State{}, TPP{}))>::value>
+struct BoundedCount {
+    static constexpr auto value = CountBetween<L, State, TPP, 0, L - Start>::value;
+};
+template<size_t L, size_t Start, class State, class TPP>
+struct BoundedCount<L, Start, State, TPP, false> {
+    static constexpr auto value = Count<L, State, TPP, (L - Start) ? 2 * (L - Start) : 1>::value;
+};
+
+template<size_t L, size_t Start, class State, class TPP>
+constexpr auto boundedStateCount = BoundedCount<L, Start, State, TPP>::value;
 #endif
 
 struct SlotStateTag {};
@@ -744,22 +871,105 @@ struct PropertyStateTag {};
 struct EnumStateTag {};
 struct ClassInfoStateTag {};
 struct InterfaceStateTag {};
+struct ConnectionStateTag {};
+
+/// Helper for indexOfMethod: index of the method whose integral constant is IC among the ones
+/// declared in T with the state Tag, or -1
+template<typename T, typename Tag, typename IC, size_t... I>
+constexpr int indexOfMethodInState(index_sequence<I...>) {
+    using TPP = T**;
+    const bool found[] = { false,
+        std::is_same<typename std::decay_t<decltype(w_state(index<I>, Tag{}, TPP{}))>::IntegralConstant, IC>::value... };
+    for (int i = 0; i < int(sizeof...(I)); ++i) {
+        if (found[i + 1])
+            return i;
+    }
+    return -1;
+}
+
+/// Compile time index of the method F (signals first, then slots, then invokable methods)
+/// relative to the methods of T, or -1 if F is not declared in T.
+/// Unlike ObjectInfo, this does not require the W_OBJECT_IMPL of T to be visible.
+template<typename T, typename F, F f>
+constexpr int indexOfMethod() {
+    using TPP = T**;
+    using IC = std::integral_constant<F, f>;
+    constexpr size_t L = 1024*1024*1024;
+    constexpr int signalCount = stateCount<L, SignalStateTag, TPP>;
+    constexpr int slotCount = stateCount<L, SlotStateTag, TPP>;
+    int i = indexOfMethodInState<T, SignalStateTag, IC>(make_index_sequence<signalCount>{});
+    if (i >= 0)
+        return i;
+    i = indexOfMethodInState<T, SlotStateTag, IC>(make_index_sequence<slotCount>{});
+    if (i >= 0)
+        return signalCount + i;
+    i = indexOfMethodInState<T, MethodStateTag, IC>(make_index_sequence<stateCount<L, MethodStateTag, TPP>>{});
+    if (i >= 0)
+        return signalCount + slotCount + i;
+    return -1;
+}
+
+/// The flags of the signal with the index I in T, or 0 if I is -1
+template<typename T, int I>
+struct SignalFlags {
+    static constexpr int value = std::decay_t<decltype(w_state(index<I>, SignalStateTag{}, static_cast<T**>(nullptr)))>::flags;
+};
+template<typename T> struct SignalFlags<T, -1> { static constexpr int value = 0; };
+
+/// The flags given to W_SIGNAL after the parameter names, found in the stringized arguments 's'.
+/// The parameter names are only in scope within the body of the signal, so the types of the flags
+/// are not known where the state of the signal is declared. The body checks the result against
+/// those types (see signalTailFlags), so a name which is not the flag cannot be taken for it.
+template<size_t SN>
+constexpr int signalFlagsFromNames(const char (&s)[SN]) {
+    constexpr char compressed[] = "W_Compressed";
+    auto flags = 0;
+    auto i = size_t{};
+    while (i < SN - 1) {
+        // one name: from i to the next comma, without the spaces and the global scope
+        auto b = i, e = i;
+        while (e < SN - 1 && s[e] != ',')
+            ++e;
+        i = e + 1;
+        while (b < e && s[b] == ' ')
+            ++b;
+        while (e > b && s[e - 1] == ' ')
+            --e;
+        if (e - b > 2 && s[b] == ':' && s[b + 1] == ':')
+            b += 2;
+        auto equal = e - b == sizeof(compressed) - 1;
+        for (auto c = size_t{}; equal && c < e - b; ++c)
+            equal = s[b + c] == compressed[c];
+        if (equal)
+            flags |= W_Compressed.value;
+    }
+    return flags;
+}
+
+/// Whether the signal F of T was declared with the W_Compressed flag
+template<typename T, typename F, F f>
+constexpr bool isCompressedSignal() {
+    constexpr int i = indexOfMethodInState<T, SignalStateTag, std::integral_constant<F, f>>(
+            make_index_sequence<stateCount<1024*1024*1024, SignalStateTag, T**>>{});
+    return (SignalFlags<T, i>::value & W_Compressed.value) != 0;
+}
 
 } // namespace w_internal
 
 #define W_OBJECT_COMMON(TYPE) \
         using W_ThisType = TYPE; \
         static constexpr auto W_UnscopedName = w_internal::viewLiteral(#TYPE); /* so we don't repeat it in W_CONSTRUCTOR */ \
+        static constexpr size_t W_CounterStart = __COUNTER__; /* see w_internal::boundedStateCount */ \
         friend struct w_internal::FriendHelper; \
         template<typename W_Flag> static inline constexpr int w_flagAlias(W_Flag) { return 0; } \
     public: \
         struct W_MetaObjectCreatorHelper;
 
 #define W_STATE_APPEND(STATE, ...) \
-    friend constexpr auto w_state(w_internal::Index<w_internal::stateCount<__COUNTER__, w_internal::STATE##Tag, W_ThisType**>>, \
+    friend constexpr auto w_state(w_internal::Index<w_internal::boundedStateCount<__COUNTER__, W_ThisType::W_CounterStart, w_internal::STATE##Tag, W_ThisType**>>, \
             w_internal::STATE##Tag, W_ThisType**) W_RETURN((__VA_ARGS__))
 #define W_STATE_APPEND_NS(STATE, ...) \
-    static constexpr auto w_state(w_internal::Index<w_internal::stateCount<__COUNTER__, w_internal::STATE##Tag, W_ThisType**>>, \
+    static constexpr auto w_state(w_internal::Index<w_internal::boundedStateCount<__COUNTER__, W_ThisType::W_CounterStart, w_internal::STATE##Tag, W_ThisType**>>, \
             w_internal::STATE##Tag, W_ThisType**) W_RETURN((__VA_ARGS__))
 
 // public macros
@@ -772,6 +982,7 @@ struct InterfaceStateTag {};
     public: \
         using W_BaseType = std::remove_reference_t<decltype(\
             w_internal::getParentObjectHelper(&W_ThisType::qt_metacast))>; \
+        using W_VerdigrisObjectType = W_ThisType; /* see w_internal::IsVerdigrisObject */ \
     Q_OBJECT \
     QT_ANNOTATE_CLASS(qt_fake, "")
 
@@ -792,6 +1003,7 @@ struct InterfaceStateTag {};
     struct W_ThisType { \
         using W_MetaObjectCreatorHelper = NAMESPACE::W_MetaObjectCreatorHelper; \
         static constexpr auto qt_static_metacall = nullptr; \
+        static constexpr size_t W_CounterStart = __COUNTER__; \
     }; \
     static constexpr auto W_UnscopedName = w_internal::viewLiteral(#NAMESPACE); \
     template<typename W_Flag> Q_DECL_UNUSED static inline constexpr int w_flagAlias(W_Flag) { Q_UNUSED(W_UnscopedName) return 0; } \
@@ -816,7 +1028,7 @@ struct InterfaceStateTag {};
             W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)(), \
             W_PARAM_TOSTRING(W_OVERLOAD_TYPES(__VA_ARGS__)), \
             W_OVERLOAD_REMOVE(__VA_ARGS__))) \
-    static inline void w_GetAccessSpecifierHelper(W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)) {}
+    static inline void w_GetAccessSpecifierHelper(W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)*) {}
 
 /// \macro W_INVOKABLE( <slot name> [, (<parameters types>) ]  [, <flags>]* )
 /// Exactly like W_SLOT but for Q_INVOKABLE methods.
@@ -827,7 +1039,7 @@ struct InterfaceStateTag {};
             W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)(), \
             W_PARAM_TOSTRING(W_OVERLOAD_TYPES(__VA_ARGS__)), \
             W_OVERLOAD_REMOVE(__VA_ARGS__))) \
-    static inline void w_GetAccessSpecifierHelper(W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)) {}
+    static inline void w_GetAccessSpecifierHelper(W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)*) {}
 
 /// <signal signature>
 /// \macro W_SIGNAL(<signal name> [, (<parameter types>) ] , <parameter names> )
@@ -838,27 +1050,37 @@ struct InterfaceStateTag {};
 /// Like W_SLOT, there can be the types of the parametter as a second argument, within parentheses.
 /// You must then follow with the parameter names
 ///
+/// The parameter names can be followed by the W_Compressed flag: a connection made with
+/// w_connectQueued to this signal keeps only the arguments of the latest emission until the
+/// receiver processes them, and then calls the slot once. This is meant for signals such as
+/// progress or position updates, when only the last value matters. The other connections,
+/// including the connections made with Qt::QueuedConnection, are not affected.
+/// Example: `void progress(int value) W_SIGNAL(progress, value, W_Compressed)`
+///
 /// Note about exported classes: since the signal is inline, GCC won't export it when compiling
 /// with -fvisibility-inlines-hidden (which is the default), so connecting using pointer to member
 /// functions won't work accross library boundaries. You need to explicitly export the signal with
 /// your MYLIB_EXPORT macro in front of the signal declaration.
 #define W_SIGNAL(...) W_MACRO_MSVC_EXPAND(W_SIGNAL2(__VA_ARGS__ , 0))
+#define W_SIGNAL_FLAGS(...) W_MACRO_MSVC_EMPTY W_MACRO_MSVC_DELAY(W_SIGNAL_FLAGS2,__VA_ARGS__)
+#define W_SIGNAL_FLAGS2(...) w_internal::W_MethodFlags<w_internal::signalFlagsFromNames("" #__VA_ARGS__)>{}
 #define W_SIGNAL2(NAME, ...) \
     { /* W_SIGNAL need to be placed directly after the signal declaration, without semicolon. */\
         using w_SignalType = decltype(W_OVERLOAD_RESOLVE(__VA_ARGS__)(&W_ThisType::NAME)); \
         return w_internal::SignalImplementation<w_SignalType, W_MACRO_CONCAT(w_signalIndex_##NAME,__LINE__)>{this}(W_OVERLOAD_REMOVE(__VA_ARGS__)); \
     } \
     static constexpr int W_MACRO_CONCAT(w_signalIndex_##NAME,__LINE__) = \
-        w_internal::stateCount<__COUNTER__, w_internal::SignalStateTag, W_ThisType**>; \
+        w_internal::boundedStateCount<__COUNTER__, W_ThisType::W_CounterStart, w_internal::SignalStateTag, W_ThisType**>; \
     friend constexpr auto w_state(w_internal::Index<W_MACRO_CONCAT(w_signalIndex_##NAME,__LINE__)>, w_internal::SignalStateTag, W_ThisType**) \
         W_RETURN(w_internal::makeMetaSignalInfo( \
                 W_OVERLOAD_RESOLVE(__VA_ARGS__)(&W_ThisType::NAME), w_internal::viewLiteral(#NAME), \
                 W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)(), \
-                W_PARAM_TOSTRING(W_OVERLOAD_TYPES(__VA_ARGS__)), W_PARAM_TOSTRING(W_OVERLOAD_REMOVE(__VA_ARGS__)))) \
-    static inline void w_GetAccessSpecifierHelper(W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)) {}
+                W_PARAM_TOSTRING(W_OVERLOAD_TYPES(__VA_ARGS__)), W_PARAM_TOSTRING(W_OVERLOAD_REMOVE(__VA_ARGS__)), \
+                W_SIGNAL_FLAGS(W_OVERLOAD_REMOVE(__VA_ARGS__)))) \
+    static inline void w_GetAccessSpecifierHelper(W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)*) {}
 
 /// \macro W_SIGNAL_COMPAT
-/// Same as W_SIGNAL, but set the W_Compat flag
+/// Same as W_SIGNAL, but set the W_Compat flag. It also accepts the W_Compressed flag.
 #define W_SIGNAL_COMPAT(...) W_MACRO_MSVC_EXPAND(W_SIGNAL_COMPAT2(__VA_ARGS__, 0))
 #define W_SIGNAL_COMPAT2(NAME, ...) \
     { \
@@ -866,13 +1088,14 @@ struct InterfaceStateTag {};
         return w_internal::SignalImplementation<w_SignalType, W_MACRO_CONCAT(w_signalIndex_##NAME,__LINE__)>{this}(W_OVERLOAD_REMOVE(__VA_ARGS__)); \
     } \
     static constexpr int W_MACRO_CONCAT(w_signalIndex_##NAME,__LINE__) = \
-        w_internal::stateCount<__COUNTER__, w_internal::SignalStateTag, W_ThisType**>; \
+        w_internal::boundedStateCount<__COUNTER__, W_ThisType::W_CounterStart, w_internal::SignalStateTag, W_ThisType**>; \
     friend constexpr auto w_state(w_internal::Index<W_MACRO_CONCAT(w_signalIndex_##NAME,__LINE__)>, w_internal::SignalStateTag, W_ThisType**) \
         W_RETURN(w_internal::makeMetaSignalInfo( \
                 W_OVERLOAD_RESOLVE(__VA_ARGS__)(&W_ThisType::NAME), w_internal::viewLiteral(#NAME), \
                 W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)(), \
-                W_PARAM_TOSTRING(W_OVERLOAD_TYPES(__VA_ARGS__)), W_PARAM_TOSTRING(W_OVERLOAD_REMOVE(__VA_ARGS__)), W_Compat)) \
-    static inline void w_GetAccessSpecifierHelper(W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)) {}
+                W_PARAM_TOSTRING(W_OVERLOAD_TYPES(__VA_ARGS__)), W_PARAM_TOSTRING(W_OVERLOAD_REMOVE(__VA_ARGS__)), \
+                W_SIGNAL_FLAGS(W_OVERLOAD_REMOVE(__VA_ARGS__)), W_Compat)) \
+    static inline void w_GetAccessSpecifierHelper(W_INTEGRAL_CONSTANT_HELPER(NAME, __VA_ARGS__)*) {}
 
 /// \macro W_CONSTRUCTOR(<parameter types>)
 /// Declares that this class can be constructed with this list of argument.
@@ -973,6 +1196,23 @@ struct InterfaceStateTag {};
 #define W_INTERFACE(A) \
     W_STATE_APPEND(InterfaceState, static_cast<A*>(nullptr))
 
+/// \macro W_CONNECTION(<sender>, <signal>, <receiver>, <slot>)
+/// Declares a connection that is made when w_installConnections(this) is called, typically at the
+/// end of the constructor, once the child objects exist.
+/// <sender> and <receiver> are W_This for the object itself, or a pointer to a data member which
+/// is a child QObject or a pointer to it.
+/// <signal> must be declared with W_SIGNAL and <slot> with W_SLOT, W_INVOKABLE or W_SIGNAL.
+/// The arguments are checked and the method indexes are computed at compile time.
+/// The connections are not made automatically: the macros cannot run code after the constructor
+/// body, where the children exist, so w_installConnections has to be called explicitly. It is not
+/// a bulk operation either: it calls QMetaObject::connect once per W_CONNECTION, because Qt has no
+/// public API to add several connections at once.
+/// Example: `W_CONNECTION(&MyWidget::m_button, &Button::clicked, W_This, &MyWidget::onClicked)`
+#define W_CONNECTION(SENDER, SIGNALPTR, RECEIVER, SLOTPTR) \
+    W_STATE_APPEND(ConnectionState, w_internal::makeMetaConnectionInfo( \
+        SENDER, std::integral_constant<decltype(SIGNALPTR), SIGNALPTR>{}, \
+        RECEIVER, std::integral_constant<decltype(SLOTPTR), SLOTPTR>{}))
+
 /// Same as Q_DECLARE_FLAGS
 #define W_DECLARE_FLAGS(Flags, Enum) \
     Q_DECLARE_FLAGS(Flags, Enum) \
@@ -991,6 +1231,119 @@ namespace w_internal { template<typename T> struct W_TypeRegistery { enum { regi
 W_REGISTER_ARGTYPE(char*)
 W_REGISTER_ARGTYPE(const char*)
 
+namespace w_internal {
+/// Returns a copy of the meta type ids of the arguments of a signal, allocated with new[], because
+/// QMetaObject::connect takes the ownership of it. The ids are the ones QObject::connect gives to a
+/// connection made with pointers to member functions: nullptr if one of the types is not a declared
+/// meta type, or is a non-const reference, which cannot be queued. Qt will then look up the types
+/// by name the first time the connection is queued, and refuse to queue a non-const reference.
+template<typename Args>
+int *queuedConnectionTypes() {
+    const int *types = QtPrivate::ConnectionTypes<Args>::types();
+    if (!types)
+        return nullptr;
+    int count = 0;
+    while (types[count])
+        ++count;
+    int *result = new int[count + 1];
+    for (int i = 0; i <= count; ++i)
+        result[i] = types[i];
+    return result;
+}
+} // namespace w_internal
+
+/// Connect the signal Signal of sender to the method Slot of receiver, like QObject::connect with
+/// pointers to member functions, but the method indexes are computed at compile time and the
+/// connection is made by index, without allocating a slot object.
+/// Slot must be declared with W_SLOT, W_INVOKABLE or W_SIGNAL, and the arguments are checked at
+/// compile time.
+/// This makes connecting cheaper, not emitting: QMetaObject::connect does not record the meta
+/// object of the receiver, so each activation calls the slot through the virtual qt_metacall of the
+/// receiver, instead of its static metacall function like a connection made with signatures, or the
+/// slot object of a connection made with pointers to member functions. Prefer QObject::connect for
+/// connections that are emitted much more often than they are made.
+/// Example: `w_connect<decltype(&Sender::sig), &Sender::sig, decltype(&Receiver::slot), &Receiver::slot>(sender, receiver)`
+template<typename SignalFunc, SignalFunc Signal, typename SlotFunc, SlotFunc Slot>
+QMetaObject::Connection w_connect(const typename QtPrivate::FunctionPointer<SignalFunc>::Object *sender,
+                                  const typename QtPrivate::FunctionPointer<SlotFunc>::Object *receiver,
+                                  Qt::ConnectionType type = Qt::AutoConnection) {
+    using SignalType = QtPrivate::FunctionPointer<SignalFunc>;
+    using SlotType = QtPrivate::FunctionPointer<SlotFunc>;
+    using SignalObj = typename SignalType::Object;
+    using SlotObj = typename SlotType::Object;
+    constexpr int signalIndex = w_internal::indexOfMethod<SignalObj, SignalFunc, Signal>();
+    constexpr int slotIndex = w_internal::indexOfMethod<SlotObj, SlotFunc, Slot>();
+    static_assert(signalIndex >= 0 && signalIndex < w_internal::stateCount<1024*1024*1024, w_internal::SignalStateTag, SignalObj**>,
+                  "Signal must be declared with W_SIGNAL");
+    static_assert(slotIndex >= 0, "Slot must be declared with W_SLOT, W_INVOKABLE or W_SIGNAL");
+    static_assert(int(SignalType::ArgumentCount) >= int(SlotType::ArgumentCount),
+                  "The slot requires more arguments than the signal provides.");
+    static_assert((QtPrivate::CheckCompatibleArguments<typename SignalType::Arguments, typename SlotType::Arguments>::value),
+                  "Signal and slot arguments are not compatible.");
+    static_assert((QtPrivate::AreArgumentsCompatible<typename SlotType::ReturnType, typename SignalType::ReturnType>::value),
+                  "Return type of the slot is not compatible with the return type of the signal.");
+    // Give the meta type ids of the arguments to explicitly queued connections, so their
+    // activations do not need to resolve the parameter type names of the signal. The other
+    // connections do not allocate them: an automatic connection which happens to be queued
+    // resolves them the first time, like with QObject::connect.
+    const auto connectionType = type & ~Qt::UniqueConnection;
+    int *types = connectionType == Qt::QueuedConnection || connectionType == Qt::BlockingQueuedConnection
+            ? w_internal::queuedConnectionTypes<typename SignalType::Arguments>() : nullptr;
+    auto connection = QMetaObject::connect(sender, SignalObj::staticMetaObject.methodOffset() + signalIndex,
+                                           receiver, SlotObj::staticMetaObject.methodOffset() + slotIndex,
+                                           type, types);
+    if (!connection)
+        delete[] types; // not owned by a connection
+    return connection;
+}
+
+#if __cplusplus > 201700L
+/// Same as above, with the types of the pointers to member functions deduced.
+/// Example: `w_connect<&Sender::sig, &Receiver::slot>(sender, receiver)`
+template<auto Signal, auto Slot>
+QMetaObject::Connection w_connect(const typename QtPrivate::FunctionPointer<decltype(Signal)>::Object *sender,
+                                  const typename QtPrivate::FunctionPointer<decltype(Slot)>::Object *receiver,
+                                  Qt::ConnectionType type = Qt::AutoConnection) {
+    return w_connect<decltype(Signal), Signal, decltype(Slot), Slot>(sender, receiver, type);
+}
+#endif
+
+namespace w_internal {
+/// Helpers for w_installConnections: the object designated by W_This or by a pointer to a data
+/// member of T in W_CONNECTION
+template<typename T>
+T *connectionObject(T *o, decltype(W_This)) { return o; }
+template<typename T, typename C, typename M>
+M *connectionObject(T *o, M *C::*member) { return o->*member; }
+template<typename T, typename C, typename M>
+std::enable_if_t<std::is_base_of<QObject, M>::value, M *> connectionObject(T *o, M C::*member) {
+    return &(o->*member);
+}
+
+template<typename T, typename Sender, typename SignalFunc, SignalFunc Signal,
+         typename Receiver, typename SlotFunc, SlotFunc Slot>
+void installConnection(T *o, const MetaConnectionInfo<Sender, std::integral_constant<SignalFunc, Signal>,
+                                                      Receiver, std::integral_constant<SlotFunc, Slot>> &c) {
+    w_connect<SignalFunc, Signal, SlotFunc, Slot>(connectionObject(o, c.sender),
+                                                  connectionObject(o, c.receiver));
+}
+
+template<typename T, size_t... I>
+void installConnections(T *o, index_sequence<I...>) {
+    using TPP = T**;
+    ordered2<int>({(installConnection(o, w_state(index<I>, ConnectionStateTag{}, TPP{})), 0)...});
+}
+} // namespace w_internal
+
+/// Make the connections declared with W_CONNECTION in the class T, in the order of declaration.
+/// Only the connections declared in T itself are made, so each class of a hierarchy should call
+/// it from its own constructor.
+template<typename T>
+void w_installConnections(T *o) {
+    constexpr size_t count = w_internal::stateCount<1024*1024*1024, w_internal::ConnectionStateTag, T**>;
+    w_internal::installConnections(o, w_internal::make_index_sequence<count>{});
+}
+
 #else // Q_MOC_RUN
 // just to avoid parse errors when moc is run over things that it should ignore
 #define W_SIGNAL(...)        ;
@@ -999,6 +1352,7 @@ W_REGISTER_ARGTYPE(const char*)
 #define W_SLOT(...)
 #define W_CLASSINFO(...)
 #define W_INTERFACE(...)
+#define W_CONNECTION(...)
 #define W_CONSTRUCTOR(...)
 #define W_FLAG(...)
 #define W_ENUM(...)
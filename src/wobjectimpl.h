@@ -23,11 +23,22 @@
 
 #include "wobjectdefs.h"
 #include <QtCore/qobject.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qvariant.h>
 
 namespace w_internal {
 
 // Match MetaDataFlags constants form the MetaDataFlags in qmetaobject_p.h
 enum : uint { IsUnresolvedType = 0x80000000, IsUnresolvedNotifySignal = 0x70000000 };
+// Index of the offset of the methods in the header of the int array, size of the header, and size
+// of the entry of a method, like in QMetaObjectPrivate
+enum : uint { HeaderMethodData = 5, HeaderSize = 14, MethodEntrySize = 5 };
+
+/// The entry I of the state State of the class, once the class is complete.
+/// Every generator goes through this variable so the overload resolution of w_state and the
+/// evaluation of the entry are done once per entry instead of once per generator and per pass.
+template<size_t I, class State, class TPP>
+constexpr auto stateValue = w_state(index<I>, State{}, TPP{});
 
 /// all details about a class T
 template<class T, class Name, size_t L = 1024*1024*1024>
@@ -53,26 +64,22 @@ struct ObjectInfo {
 #if __cplusplus > 201700L
     template<size_t Idx>
     static constexpr auto method(Index<Idx>) {
-        using TPP = T**;
-        if constexpr (Idx < signalCount) return w_state(index<Idx>, SignalStateTag{}, TPP{});
-        else if constexpr (Idx - signalCount < slotCount) return w_state(index<Idx - signalCount>, SlotStateTag{}, TPP{});
-        else return w_state(index<Idx - signalCount - slotCount>, MethodStateTag{}, TPP{});
+        if constexpr (Idx < signalCount) return stateValue<Idx, SignalStateTag, T**>;
+        else if constexpr (Idx - signalCount < slotCount) return stateValue<Idx - signalCount, SlotStateTag, T**>;
+        else return stateValue<Idx - signalCount - slotCount, MethodStateTag, T**>;
     }
 #else
     template<size_t Idx>
     static constexpr auto method(Index<Idx>, std::enable_if_t<(Idx < signalCount)>* = {}) {
-        using TPP = T**;
-        return w_state(index<Idx>, SignalStateTag{}, TPP{});
+        return stateValue<Idx, SignalStateTag, T**>;
     }
     template<size_t Idx>
     static constexpr auto method(Index<Idx>, std::enable_if_t<(Idx >= signalCount && Idx - signalCount < slotCount)>* = {}) {
-        using TPP = T**;
-        return w_state(index<Idx - signalCount>, SlotStateTag{}, TPP{});
+        return stateValue<Idx - signalCount, SlotStateTag, T**>;
     }
     template<size_t Idx>
     static constexpr auto method(Index<Idx>, std::enable_if_t<(Idx >= signalCount + slotCount)>* = {}) {
-        using TPP = T**;
-        return w_state(index<Idx - signalCount - slotCount>, MethodStateTag{}, TPP{});
+        return stateValue<Idx - signalCount - slotCount, MethodStateTag, T**>;
     }
 #endif
 };
@@ -87,24 +94,17 @@ constexpr void fold(index_sequence<Is...>, F&& f) {
 #endif
 }
 
-#if __cplusplus > 201700L
-template <size_t L, class State, class TPP, class F>
-constexpr void foldState(F&& f) {
-    fold(make_index_sequence<stateCount<L, State, TPP>>{}, [&](auto i) { f(w_state(i, State{}, TPP{}), i); });
-}
-#else
 template<class F, class State, class TPP>
 struct FoldState {
     F&& f;
-    template<class I>
-    constexpr void operator() (I i) { f(w_state(i, State{}, TPP{}), i); }
+    template<size_t I>
+    constexpr void operator() (Index<I> i) { f(stateValue<I, State, TPP>, i); }
 };
 template <size_t L, class State, class TPP, class F>
 constexpr void foldState(F&& f) {
     auto fs = FoldState<F, State, TPP>{std::forward<F>(f)};
     fold(make_index_sequence<stateCount<L, State, TPP>>{}, fs);
 }
-#endif
 
 template <size_t L, class T, class F>
 constexpr void foldMethods(F&& f) {
@@ -123,34 +123,94 @@ constexpr auto fetchExplicitName(const StringView&, int) -> decltype (w_explicit
     return w_explicitObjectName(static_cast<T*>(nullptr));
 }
 
+/// Table of the signals of O, as pointers to member function of type Func.
+/// The signals which cannot be converted to Func are null, so they never match.
+/// There is one table per class and type, so resolving the NOTIFY signals of all the properties
+/// instantiates the entries of the signals once, instead of once per property.
+template<size_t L, typename O, typename Func, typename Seq = make_index_sequence<stateCount<L, SignalStateTag, O**>>>
+struct SignalTable;
+template<size_t L, typename O, typename Func, size_t... SigI>
+struct SignalTable<L, O, Func, index_sequence<SigI...>> {
+private:
+    using OP = O**;
+    template<size_t I, typename SigF = std::remove_const_t<decltype(stateValue<I, SignalStateTag, OP>.func)>>
+    static constexpr Func entry(std::enable_if_t<std::is_convertible<SigF, Func>::value>* = {}) {
+        return stateValue<I, SignalStateTag, OP>.func;
+    }
+    template<size_t I, typename SigF = std::remove_const_t<decltype(stateValue<I, SignalStateTag, OP>.func)>>
+    static constexpr Func entry(std::enable_if_t<!std::is_convertible<SigF, Func>::value>* = {}) {
+        return nullptr;
+    }
+public:
+    static constexpr Func funcs[] = { entry<SigI>()..., nullptr };
+
+    /// Returns the index of the signal f in O, or -1.
+    /// If f is registered more than once, this is the index of the last one.
+    static constexpr int indexOf(Func f) {
+        for (size_t i = sizeof...(SigI); i > 0; --i) {
+            if (funcs[i - 1] == f)
+                return int(i - 1);
+        }
+        return -1;
+    }
+};
+#if __cplusplus < 201700L
+template<size_t L, typename O, typename Func, size_t... SigI>
+constexpr Func SignalTable<L, O, Func, index_sequence<SigI...>>::funcs[];
+#endif
+
 /// Helper to get information about the notify signal of the property within object T
 template<size_t L, size_t PropIdx, typename T, typename O>
 struct ResolveNotifySignal {
 private:
     using TP = T**;
-    using OP = O**;
-    static constexpr auto prop = w_state(index<PropIdx>, PropertyStateTag{}, TP{});
+    static constexpr auto prop = stateValue<PropIdx, PropertyStateTag, TP>;
+    using Func = std::remove_const_t<decltype(prop.notify)>;
+public:
+    static constexpr int signalIndex() {
+        return SignalTable<L, O, Func>::indexOf(prop.notify);
+    }
+};
 
-    template<size_t SigIdx, bool Eq = w_state(index<SigIdx>, SignalStateTag{}, OP{}).func == prop.notify>
-    static constexpr auto match(int) { return Eq; }
-    template<size_t SigIdx>
-    static constexpr auto match(float) { return false; }
+QT_WARNING_PUSH
+QT_WARNING_DISABLE_GCC("-Waddress")
+/// Helper for implementation of qt_static_metacall for QMetaObject::IndexOfMethod
+/// Finds the index of a signal of T from the type-erased pointer to member function 'func'.
+/// Only the signals can match, and the search stops at the first match. Each signal is
+/// compared in its own pointer to member function type, like moc does.
+/// Qt gives the pointer without its type, so the signals cannot be filtered by signature first.
+template<typename T>
+struct SignalIndexOf {
+private:
+    using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
+
+    template<size_t I>
+    static bool matchAt(void **func, int &r) {
+        constexpr auto f = ObjI::method(index<I>).func;
+        if (*reinterpret_cast<std::remove_const_t<decltype(f)>*>(func) != f)
+            return false;
+        r = int(I);
+        return true;
+    }
 
     template<size_t... Is>
-    static constexpr int indexFold(index_sequence<Is...>) {
-        int r = -1;
+    static int find(void **func, index_sequence<Is...>) {
+        auto r = int{-1};
 #if __cplusplus > 201700L
-        ((match<Is>(0) ? r = (int)Is : 0), ...);
+        (void)(false || ... || matchAt<Is>(func, r));
 #else
-        ordered2<int>({(match<Is>(0) ? r = (int)Is : 0)...});
+        auto found = false;
+        ordered2<bool>({(found = found || matchAt<Is>(func, r))...});
 #endif
         return r;
     }
 public:
-    static constexpr int signalIndex() {
-        return indexFold(make_index_sequence<stateCount<L, SignalStateTag, O**>>{});
+    /// Returns the relative index of the signal pointed to by func in T, or -1
+    static int value(void **func) {
+        return find(func, make_index_sequence<ObjI::signalCount>{});
     }
 };
+QT_WARNING_POP
 
 /// returns true if the object T has at least one property with a notify signal
 #if __cplusplus > 201700L
@@ -192,8 +252,12 @@ struct ClassInfoGenerator {
 };
 
 /// auto-detect the access specifiers
+/// Every W_SLOT, W_INVOKABLE and W_SIGNAL declares an overload of w_GetAccessSpecifierHelper taking a
+/// pointer to the IntegralConstant of the method, with the access of the location of the macro.
+/// The overloads which do not match are discarded without looking for conversions, since the
+/// parameters are pointers to unrelated types.
 template<class T, class M>
-auto test_public(int) -> std::enable_if_t<std::is_same<void, decltype(T::w_GetAccessSpecifierHelper(M{}))>::value, std::true_type>;
+auto test_public(int) -> std::enable_if_t<std::is_same<void, decltype(T::w_GetAccessSpecifierHelper(static_cast<M*>(nullptr)))>::value, std::true_type>;
 template<class T, class M>
 auto test_public(float) -> std::false_type;
 template<class T, class M>
@@ -201,8 +265,21 @@ using isPublic = decltype(test_public<T, M>(0));
 
 template <typename T, typename M, typename = void> struct isProtected : std::false_type {};
 template <typename T, typename = std::enable_if_t<!std::is_final<T>::value>>
-struct Derived : T { template<typename M, typename X = T> static decltype(X::w_GetAccessSpecifierHelper(std::declval<M>())) test(M); };
-template <typename T, typename M> struct isProtected<T, M, decltype(Derived<T>::test(std::declval<M>()))> : std::true_type {};
+struct Derived : T { template<typename M, typename X = T> static decltype(X::w_GetAccessSpecifierHelper(static_cast<M*>(nullptr))) test(M*); };
+template <typename T, typename M> struct isProtected<T, M, decltype(Derived<T>::test(static_cast<M*>(nullptr)))> : std::true_type {};
+
+/// Access flag of the method M of T. isProtected is only checked for the methods which are not public.
+template<typename T, typename M, bool = isPublic<T, M>::value>
+struct DetectedAccess : std::integral_constant<uint, W_Access::Public.value> {};
+template<typename T, typename M>
+struct DetectedAccess<T, M, false> : std::integral_constant<uint,
+        isProtected<T, M>::value ? W_Access::Protected.value : W_Access::Private.value> {};
+
+/// Nothing is detected if the access was given to the macro
+template<typename T, typename M, bool Explicit>
+struct AccessFlag : std::integral_constant<uint, 0> {};
+template<typename T, typename M>
+struct AccessFlag<T, M, false> : DetectedAccess<T, M> {};
 
 template<class State, class T>
 struct MethodGenerator {
@@ -217,18 +294,19 @@ struct MethodGenerator {
         s.addInts((uint)Method::argCount,
                    parameterIndex, //parameters
                    1, //tag, always \0
-                   adjustFlags(Method::flags, typename Method::IntegralConstant()));
+                   adjustFlags<Method>());
         parameterIndex += 1 + Method::argCount * 2;
     }
 
 private:
-    template<typename M>
-    static constexpr uint adjustFlags(uint f, M) {
-        if (!(f & (W_Access::Protected.value | W_Access::Private.value | W_Access::Public.value))) {
-            // Auto-detect the access specifier
-            f |= isPublic<T, M>::value ? W_Access::Public.value : isProtected<T,M>::value ? W_Access::Protected.value : W_Access::Private.value;
-        }
-        return f & static_cast<uint>(~W_Access::Private.value); // Because QMetaMethod::Private is 0, but not W_Access::Private;
+    template<typename Method>
+    static constexpr uint adjustFlags() {
+        constexpr uint accessMask = W_Access::Protected.value | W_Access::Private.value | W_Access::Public.value;
+        // Auto-detect the access specifier
+        constexpr uint f = Method::flags
+            | AccessFlag<T, typename Method::IntegralConstant, (Method::flags & accessMask) != 0>::value;
+        // Because QMetaMethod::Private is 0, but not W_Access::Private; and W_Compressed is not a Qt flag
+        return f & static_cast<uint>(~(W_Access::Private.value | W_Compressed.value));
     }
 };
 
@@ -344,7 +422,7 @@ private:
         static_assert(signalIndex >= 0, "NOTIFY signal in parent class not registered as a W_SIGNAL");
         static_assert(signalIndex < 0 || QT_VERSION >= QT_VERSION_CHECK(5, 10, 0),
                       "NOTIFY signal in parent class requires Qt 5.10");
-        constexpr auto sig = w_state(index<signalIndex>, SignalStateTag{}, OP{});
+        constexpr auto sig = stateValue<signalIndex, SignalStateTag, OP>;
         s.template addTypeString<IsUnresolvedNotifySignal>(sig.name);
     }
 };
@@ -512,50 +590,6 @@ struct ConstructorParametersGenerator {
     }
 };
 
-/// Given method, a binary::tree containing information about methods or constructor,
-/// return the amount of item it will add in the int array.
-#if __cplusplus > 201700L
-template<size_t L, class T>
-constexpr int methodsParamOffset() {
-    auto sum = int{};
-    foldMethods<L, T>([&](auto m, auto) { sum += int(1 + m.argCount * 2); });
-    return sum;
-}
-#else
-struct MethodParamOffset {
-    int sum{};
-    template<class M, class I>
-    constexpr void operator() (M m, I) { sum += int(1 + m.argCount * 2); }
-};
-template<size_t L, class T>
-constexpr int methodsParamOffset() {
-    auto mpo = MethodParamOffset{};
-    foldMethods<L, T>(mpo);
-    return mpo.sum;
-}
-#endif
-#if __cplusplus > 201700L
-template<size_t L, class T>
-constexpr int constructorParamOffset() {
-    auto sum = int{};
-    foldState<L, ConstructorStateTag, T>([&](auto m, auto) { sum += int(1 + m.argCount * 2); });
-    return sum;
-}
-#else
-struct ConstructorParamOffset {
-    int sum{};
-    template<class M, class I>
-    constexpr void operator() (M m, I) { sum += int(1 + m.argCount * 2); }
-};
-template<size_t L, class T>
-constexpr int constructorParamOffset() {
-    auto cpo = ConstructorParamOffset{};
-    foldState<L, ConstructorStateTag, T>(cpo);
-    return cpo.sum;
-}
-
-#endif
-
 template<class T, size_t N> using RawArray = T[N];
 template<class T, size_t N> struct OwnArray {
     RawArray<T, N> data{};
@@ -565,106 +599,99 @@ template<class T, size_t N> struct OwnArray {
     }
 };
 
-struct LayoutBuilder {
+/// Offsets and sizes of the generated data, known after the first pass
+struct DataLayout {
     size_t stringSize{};
     uint stringCount{};
     uint intCount{};
-
-    constexpr void addString(const StringView& s) {
-        stringSize += s.size() + 1;
-        stringCount += 1;
-        intCount += 1;
-    }
-    constexpr void addStringUntracked(const StringView& s) {
-        stringSize += s.size() + 1;
-        stringCount += 1;
-    }
-    template<uint Flag = IsUnresolvedType>
-    constexpr void addTypeString(const StringView& s) {
-        stringSize += s.size() + 1;
-        stringCount += 1;
-        intCount += 1;
-    }
-    template<class... Ts>
-    constexpr void addInts(Ts...) {
-        intCount += sizeof... (Ts);
-    }
+    int constructorParamIndex{};
+    int enumValueOffset{};
 };
+
+/// State of generateDataPass.
+/// Without holder, it only computes the DataLayout. With a holder, it fills its arrays.
+/// Both passes use the same State type so the generators are only instantiated once.
 struct DataBuilder {
     char* stringCharP{};
     qptrdiff* stringOffestP{};
     int* stringLengthP{};
     uint* intP{};
+    size_t stringSize{};
     uint stringCount{};
     uint intCount{};
     qptrdiff stringOffset{};
+    DataLayout layout{};
 
     constexpr DataBuilder() = default;
     DataBuilder(const DataBuilder&) = delete;
     template<class Holder>
-    constexpr DataBuilder(Holder& r)
+    constexpr DataBuilder(Holder& r, const DataLayout& layout)
         : stringCharP(r.stringChars)
         , stringOffestP(r.stringOffsets)
         , stringLengthP(r.stringLengths)
         , intP(r.ints)
-        , stringOffset(r.stringOffset) {}
+        , stringOffset(r.stringOffset)
+        , layout(layout) {}
 
     constexpr void addString(const StringView& s) {
-        for (auto c : s) *stringCharP++ = c;
-        *stringCharP++ = '\0';
-        *stringOffestP++ = stringOffset;
-        *stringLengthP++ = s.size();
-        *intP++ = stringCount;
-        stringOffset += 1 + s.size() - qptrdiff(sizeof(QByteArrayData));
-        stringCount += 1;
-        intCount += 1;
+        addStringUntracked(s);
+        addInt(stringCount - 1);
     }
     constexpr void addStringUntracked(const StringView& s) {
-        for (auto c : s) *stringCharP++ = c;
-        *stringCharP++ = '\0';
-        *stringOffestP++ = stringOffset;
-        *stringLengthP++ = s.size();
+        if (stringCharP) {
+            for (auto c : s) *stringCharP++ = c;
+            *stringCharP++ = '\0';
+            *stringOffestP++ = stringOffset;
+            *stringLengthP++ = s.size();
+        }
         stringOffset += 1 + s.size() - qptrdiff(sizeof(QByteArrayData));
+        stringSize += s.size() + 1;
         stringCount += 1;
     }
 
     template<uint Flag = IsUnresolvedType>
     constexpr void addTypeString(const StringView& s) {
-        for (auto c : s) *stringCharP++ = c;
-        *stringCharP++ = '\0';
-        *stringOffestP++ = stringOffset;
-        *stringLengthP++ = s.size();
-        *intP++ = Flag | stringCount;
-        stringOffset += 1 + s.size() - qptrdiff(sizeof(QByteArrayData));
-        stringCount += 1;
-        intCount += 1;
+        addStringUntracked(s);
+        addInt(Flag | (stringCount - 1));
     }
     template<class... Ts>
     constexpr void addInts(Ts... vs) {
 #if __cplusplus > 201700L
-        ((*intP++ = vs),...);
+        (addInt(vs),...);
 #else
-        ordered2<uint>({(*intP++ = vs)...});
+        ordered2<uint>({(addInt(vs), 0u)...});
 #endif
-        intCount += sizeof... (Ts);
+    }
+
+    constexpr DataLayout result() const {
+        return { stringSize, stringCount, intCount, layout.constructorParamIndex, layout.enumValueOffset };
+    }
+
+private:
+    constexpr void addInt(uint v) {
+        if (intP) *intP++ = v;
+        intCount += 1;
     }
 };
 
 
 /// fold ObjectInfo into State
-template<typename T, typename State>
-constexpr void generateDataPass(State& state) {
+/// This is evaluated twice per class, since the sizes of the arrays are template arguments of
+/// their holder: the first pass (without holder) computes the DataLayout, which also gives the
+/// offsets of the constructor parameters and of the enum values to the second pass, so the
+/// methods do not need to be folded once more to compute them.
+template<typename T>
+constexpr void generateDataPass(DataBuilder& state) {
+    using State = DataBuilder;
     using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
     constexpr size_t L = ObjI::counter;
     constexpr bool hasNotify = hasNotifySignal<L, T**>();
-    constexpr int classInfoOffset = 14;
+    constexpr int classInfoOffset = HeaderSize;
     constexpr int methodOffset = classInfoOffset + ObjI::classInfoCount * 2;
-    constexpr int propertyOffset = methodOffset + ObjI::methodCount * 5;
+    constexpr int propertyOffset = methodOffset + ObjI::methodCount * MethodEntrySize;
     constexpr int enumOffset = propertyOffset + ObjI::propertyCount * (hasNotify ? 4: 3);
     constexpr int constructorOffset = enumOffset + ObjI::enumCount * (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0) ? 5 : 4);
     constexpr int paramIndex = constructorOffset + ObjI::constructorCount * 5 ;
-    constexpr int constructorParamIndex = paramIndex + methodsParamOffset<L, T**>();
-    constexpr int enumValueOffset = constructorParamIndex + constructorParamOffset<L, T**>();
 
     state.addInts(QT_VERSION >= QT_VERSION_CHECK(5, 12, 0) ? 8 : 7); // revision
     state.addString(ObjI::name);
@@ -689,37 +716,37 @@ constexpr void generateDataPass(State& state) {
     foldState<L, PropertyStateTag, T**>(NotifySignalGenerator<State, L, T, hasNotify>{state});
 
     //if (state.intCount != enumOffset) throw "offset mismatch!";
-    foldState<L, EnumStateTag, T**>(EnumGenerator<State>{state, enumValueOffset});
+    foldState<L, EnumStateTag, T**>(EnumGenerator<State>{state, state.layout.enumValueOffset});
 
     //if (state.intCount != constructorOffset) throw "offset mismatch!";
-    foldState<L, ConstructorStateTag, T**>(MethodGenerator<State, T>{state, constructorParamIndex});
+    foldState<L, ConstructorStateTag, T**>(MethodGenerator<State, T>{state, state.layout.constructorParamIndex});
 
     //if (state.intCount != paramIndex) throw "offset mismatch!";
     foldMethods<L, T**>(MethodParametersGenerator<State>{state});
 
-    //if (state.intCount != constructorParamIndex) throw "offset mismatch!";
+    state.layout.constructorParamIndex = int(state.intCount);
     foldState<L, ConstructorStateTag, T**>(ConstructorParametersGenerator<State>{state});
 
-    //if (state.intCount != enumValueOffset) throw "offset mismatch!";
+    state.layout.enumValueOffset = int(state.intCount);
     foldState<L, EnumStateTag, T**>(EnumValuesGenerator<State>{state});
 }
 
 #if __cplusplus > 201700L
 template<class T>
-constexpr LayoutBuilder dataLayout = [](){
-    auto r = LayoutBuilder{};
-    generateDataPass<T>(r);
-    return r;
+constexpr DataLayout dataLayout = [](){
+    DataBuilder b{};
+    generateDataPass<T>(b);
+    return b.result();
 }();
 #else
 template<class T>
 constexpr auto createLayout() {
-    auto r = LayoutBuilder{};
-    generateDataPass<T>(r);
-    return r;
+    DataBuilder b{};
+    generateDataPass<T>(b);
+    return b.result();
 }
 template<class T>
-constexpr LayoutBuilder dataLayout = createLayout<T>();
+constexpr DataLayout dataLayout = createLayout<T>();
 #endif
 
 /// Final data holder
@@ -754,14 +781,14 @@ struct MetaDataProvider {
 #if __cplusplus > 201700L
     constexpr static Arrays arrays = []() {
         auto r = Arrays{};
-        DataBuilder b{r};
+        DataBuilder b{r, dataLayout<T>};
         generateDataPass<T>(b);
         return r;
     }();
 #else
     constexpr static auto buildArrays() {
         auto r = Arrays{};
-        DataBuilder b{r};
+        DataBuilder b{r, dataLayout<T>};
         generateDataPass<T>(b);
         return r;
     }
@@ -808,6 +835,31 @@ inline auto propSet(F f, O *o, const T &t) W_RETURN(o->*f = t)
 template <typename O, typename T>
 inline void propSet(Empty, O *, const T &) {}
 
+/// Whether the value written by a WriteProperty metacall can be moved from. QMetaProperty::write
+/// passes in _a[1] its own copy of the QVariant holding the value in _a[0], so the value is not
+/// used after the call if that QVariant does not share it. Other callers pass nullptr in _a[1].
+/// This layout is not documented by Qt. It was checked in the machine code of
+/// QMetaProperty::write in Qt 5.15.19, where argv is { v.data(), &v, &status, &flags } with v the
+/// local copy of the written QVariant (&v for both when the property is a QVariant). A caller passing anything but nullptr or a
+/// QVariant in _a[1] would have it read as a QVariant; the value is then only moved if that
+/// QVariant points to the value in _a[0].
+inline bool canMoveWrittenValue(void **_a) {
+    auto variant = static_cast<const QVariant *>(_a[1]);
+    return variant && variant->constData() == _a[0] && variant->isDetached();
+}
+
+/// Calls a setter which takes its argument by value or by rvalue reference: the value is moved
+/// in it if the caller allows it, otherwise the setter gets a copy
+template <typename F, typename O, typename T>
+inline void propSetValue(F f, O *o, T &t, void **_a, std::true_type) {
+    if (canMoveWrittenValue(_a))
+        (o->*f)(std::move(t));
+    else
+        (o->*f)(T(t));
+}
+template <typename F, typename O, typename T>
+inline void propSetValue(F f, O *o, T &t, void **, std::false_type) { propSet(f, o, t); }
+
 template <typename F, typename O, typename T>
 inline auto propGet(F f, O *o, T &t) W_RETURN(t = (o->*f)())
 template <typename F, typename O, typename T>
@@ -815,6 +867,13 @@ inline auto propGet(F f, O *o, T &t) W_RETURN(t = o->*f)
 template <typename O, typename T>
 inline void propGet(Empty, O *, T &) {}
 
+/// Returns whether the member m of o is equal to t. If the type has no operator==, the values
+/// are always considered different.
+template <typename M, typename O, typename T>
+inline auto propEquals(M m, O *o, const T &t, int) W_RETURN(bool(o->*m == t))
+template <typename M, typename O, typename T>
+inline bool propEquals(M, O *, const T &, ...) { return false; }
+
 template <typename F, typename M, typename O>
 inline auto propNotify(F f, M m, O *o) W_RETURN(((o->*f)(o->*m),0))
 template <typename F, typename M, typename O>
@@ -827,6 +886,152 @@ inline auto propReset(F f, O *o) W_RETURN(((o->*f)(),0))
 template <typename... T>
 inline void propReset(T...) {}
 
+/// Compute if T is declared with W_OBJECT. A class deriving from such a class without W_OBJECT
+/// inherits the marker of its base, so the marker must name T itself.
+/// This only depends on the class definition, so all the translation units agree on it.
+template<typename T, typename = void> struct IsVerdigrisObject : std::false_type {};
+template<typename T> struct IsVerdigrisObject<T, std::enable_if_t<
+        std::is_same<typename T::W_VerdigrisObjectType, T>::value>> : std::true_type {};
+
+/// Helper for qt_metacall_impl: T and its direct bases which are Verdigris objects form a chain of
+/// classes whose amount of methods and properties are known at compile time.
+/// Root is the first base class which is not part of the chain.
+/// methodOffset, propertyOffset and enumOffset are the offsets of T's methods, properties and enums
+/// relative to Root.
+template<typename T, bool = IsVerdigrisObject<typename T::W_BaseType>::value>
+struct MetaCallChain {
+    using Root = typename T::W_BaseType;
+    static constexpr int methodOffset = 0;
+    static constexpr int propertyOffset = 0;
+    static constexpr int enumOffset = 0;
+};
+template<typename T>
+struct MetaCallChain<T, true> {
+    using Base = typename T::W_BaseType;
+    using BaseTPP = Base**;
+    static constexpr size_t L = 1024*1024*1024;
+    using Root = typename MetaCallChain<Base>::Root;
+    // The counts come from the state of Base, which does not need the W_OBJECT_IMPL of Base
+    static constexpr int methodOffset = MetaCallChain<Base>::methodOffset + int(stateCount<L, SignalStateTag, BaseTPP>
+            + stateCount<L, SlotStateTag, BaseTPP> + stateCount<L, MethodStateTag, BaseTPP>);
+    static constexpr int propertyOffset = MetaCallChain<Base>::propertyOffset + int(stateCount<L, PropertyStateTag, BaseTPP>);
+    static constexpr int enumOffset = MetaCallChain<Base>::enumOffset + int(stateCount<L, EnumStateTag, BaseTPP>);
+};
+
+/// Flat table of the meta type ids of the arguments of every method of T, used for
+/// QMetaObject::RegisterMethodArgumentMetaType.
+/// It is filled the first time it is used, then a lookup is a single indexed load.
+template<typename T, typename Seq> struct MethodArgumentTypes;
+template<typename T, size_t... MethI>
+struct MethodArgumentTypes<T, index_sequence<MethI...>> {
+private:
+    using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
+    template<size_t I> using Method = decltype(ObjI::method(index<I>));
+    static constexpr int argumentCount = summed<Method<MethI>::argCount...>;
+
+    int offsets[sizeof...(MethI) + 1] = {};
+    int types[argumentCount + 1] = {};
+
+    MethodArgumentTypes() {
+        auto offset = int{};
+        ordered2<int>({(fill<MethI>(offset), 0)...});
+        offsets[sizeof...(MethI)] = offset;
+    }
+
+    template<size_t I>
+    void fill(int &offset) {
+        using P = QtPrivate::FunctionPointer<std::remove_const_t<decltype(Method<I>::func)>>;
+        const int *t = QtPrivate::ConnectionTypes<typename P::Arguments>::types();
+        offsets[I] = offset;
+        for (int i = 0; i < int(P::ArgumentCount); ++i)
+            types[offset + i] = t ? t[i] : -1;
+        offset += P::ArgumentCount;
+    }
+
+public:
+    /// Returns the meta type id of the argument 'arg' of the method 'id', or -1
+    static int metaType(int id, uint arg) {
+        static const MethodArgumentTypes table;
+        if (uint(id) >= sizeof...(MethI) || arg >= uint(table.offsets[id + 1] - table.offsets[id]))
+            return -1;
+        return table.types[table.offsets[id] + arg];
+    }
+};
+
+/// Table of the meta type ids of the properties of T, used for
+/// QMetaObject::RegisterPropertyMetaType. It is filled the first time it is used.
+template<typename T, typename Seq> struct PropertyTypes;
+template<typename T, size_t... PropI>
+struct PropertyTypes<T, index_sequence<PropI...>> {
+    /// Returns the meta type id of the property 'id', or -1
+    static int metaType(int id) {
+        using TPP = T**;
+        static const int types[] = { QtPrivate::QMetaTypeIdHelper<
+            typename decltype(stateValue<PropI, PropertyStateTag, TPP>)::PropertyType>::qt_metatype_id()..., -1 };
+        return uint(id) < sizeof...(PropI) ? types[id] : -1;
+    }
+};
+
+/// Hash a null terminated string (FNV-1a), and compute its size at the same time
+constexpr uint hashString(const char *s, size_t &size) {
+    auto h = uint{2166136261u};
+    auto i = size_t{};
+    for (; s[i]; ++i)
+        h = (h ^ uchar(s[i])) * 16777619u;
+    size = i;
+    return h;
+}
+
+/// Table of the IIDs of the interfaces of T (W_INTERFACE), used by qt_metacast.
+/// The IIDs from Q_DECLARE_INTERFACE are only available at run time, so their size and hash are
+/// computed the first time the table is used. A lookup then hashes the class name once, and
+/// only compares the strings of the interfaces that have the same hash.
+template<typename T, typename Seq> struct InterfaceTable;
+template<typename T>
+struct InterfaceTable<T, index_sequence<>> {
+    static void *cast(T *, const char *) { return nullptr; }
+};
+template<typename T, size_t... Is>
+struct InterfaceTable<T, index_sequence<Is...>> {
+private:
+    using TPP = T**;
+    template<size_t I> using Interface = decltype(w_state(index<I>, InterfaceStateTag{}, TPP{}));
+
+    struct Entry {
+        const char *iid;
+        size_t size;
+        uint hash;
+    };
+    Entry entries[sizeof...(Is)];
+
+    InterfaceTable() : entries{ makeEntry(qobject_interface_iid<Interface<Is>>())... } {}
+
+    static Entry makeEntry(const char *iid) {
+        auto size = size_t{};
+        const auto hash = iid ? hashString(iid, size) : 0u;
+        return { iid, size, hash };
+    }
+
+    template<size_t I>
+    static void *castTo(T *o) { return static_cast<Interface<I>>(o); }
+
+public:
+    /// Returns o casted to the interface with the IID clname, or nullptr
+    static void *cast(T *o, const char *clname) {
+        static const InterfaceTable table;
+        using Caster = void *(*)(T *);
+        static constexpr Caster casters[] = { &castTo<Is>... };
+        auto size = size_t{};
+        const auto hash = hashString(clname, size);
+        for (size_t i = 0; i < sizeof...(Is); ++i) {
+            const Entry &e = table.entries[i];
+            if (e.iid && e.hash == hash && e.size == size && !memcmp(e.iid, clname, size))
+                return casters[i](o);
+        }
+        return nullptr;
+    }
+};
+
 struct FriendHelper {
 
     template<typename T>
@@ -839,102 +1044,147 @@ struct FriendHelper {
 #endif
     }
 
+    /// Call the qt_static_metacall of T. The base classes in the chain are called through their
+    /// meta object: their W_OBJECT_IMPL may be in another library, where qt_static_metacall is hidden.
+    template<typename T>
+    static void staticMetacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a, std::false_type /*isBase*/) {
+        T::qt_static_metacall(_o, _c, _id, _a);
+    }
+    template<typename T>
+    static void staticMetacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a, std::true_type /*isBase*/) {
+        T::staticMetaObject.d.static_metacall(_o, _c, _id, _a);
+    }
+
+    /// Call the qt_static_metacall of the class that owns the method or property _id in the chain
+    /// of Verdigris objects ending with T. _id is relative to the Root of the chain.
+    template<typename T, bool IsMethod, typename IsBase = std::false_type>
+    static void chainStaticMetacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a, std::false_type) {
+        staticMetacall<T>(_o, _c, _id, _a, IsBase{});
+    }
+    template<typename T, bool IsMethod, typename IsBase = std::false_type>
+    static void chainStaticMetacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a, std::true_type) {
+        using Chain = MetaCallChain<T>;
+        constexpr int offset = IsMethod ? Chain::methodOffset : Chain::propertyOffset;
+        if (_id >= offset) {
+            staticMetacall<T>(_o, _c, _id - offset, _a, IsBase{});
+        } else {
+            using Base = typename T::W_BaseType;
+            chainStaticMetacall<Base, IsMethod, std::true_type>(_o, _c, _id, _a,
+                                                                IsVerdigrisObject<typename Base::W_BaseType>{});
+        }
+    }
+
+    /// Implementation of qt_metacall.
+    /// Instead of going through the qt_metacall of every base class, the qt_metacall of the Root
+    /// of the chain of Verdigris objects is called, then the owner of _id is found with the
+    /// offsets known at compile time and its qt_static_metacall is called directly.
     template<typename T> static int qt_metacall_impl(T *_o, QMetaObject::Call _c, int _id, void** _a) {
         using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
-        _id = _o->T::W_BaseType::qt_metacall(_c, _id, _a);
+        using Chain = MetaCallChain<T>;
+        using HasChain = IsVerdigrisObject<typename T::W_BaseType>;
+        _id = _o->Chain::Root::qt_metacall(_c, _id, _a);
         if (_id < 0)
             return _id;
         if (_c == QMetaObject::InvokeMetaMethod || _c == QMetaObject::RegisterMethodArgumentMetaType) {
-            constexpr int methodCount = ObjI::methodCount;
+            constexpr int methodCount = Chain::methodOffset + ObjI::methodCount;
             if (_id < methodCount)
-                T::qt_static_metacall(_o, _c, _id, _a);
+                chainStaticMetacall<T, true>(_o, _c, _id, _a, HasChain{});
             _id -= methodCount;
         } else if ((_c >= QMetaObject::ReadProperty && _c <= QMetaObject::QueryPropertyUser)
                     || _c == QMetaObject::RegisterPropertyMetaType) {
-            constexpr int propertyCount = ObjI::propertyCount;
+            constexpr int propertyCount = Chain::propertyOffset + ObjI::propertyCount;
             if (_id < propertyCount)
-                T::qt_static_metacall(_o, _c, _id, _a);
+                chainStaticMetacall<T, false>(_o, _c, _id, _a, HasChain{});
             _id -= propertyCount;
         }
         return _id;
     }
 
-QT_WARNING_PUSH
-QT_WARNING_DISABLE_GCC("-Waddress")
-    /// Helper for implementation of qt_static_metacall for QMetaObject::IndexOfMethod
-    /// T is the class, and I is the index of a method.
-    /// Returns I if the argument is equal to the pointer to member function of the signal of index 'I'
-    template<typename T, int I>
-    static int indexOfMethod(void **func) {
-        using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
-        constexpr auto m = ObjI::method(index<I>);
-        if ((m.flags & 0xc) == W_MethodType::Signal.value
-            && m.func == *reinterpret_cast<decltype(m.func)*>(func))
-            return I;
-        return -1;
-    }
-QT_WARNING_POP
-
     /// Helper for implementation of qt_static_metacall for QMetaObject::InvokeMetaMethod
     /// T is the class, and I is the index of a method.
-    /// Invoke the method with index I if id == I.
+    /// Invoke the method with index I.
     template <typename T, int I>
-    static void invokeMethod(T *_o, int _id, void **_a) {
-        if (_id == I) {
-            using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
-            constexpr auto f = ObjI::method(index<I>).func;
-            using P = QtPrivate::FunctionPointer<std::remove_const_t<decltype(f)>>;
-            P::template call<typename P::Arguments, typename P::ReturnType>(f, _o, _a);
-        }
+    static void invokeMethod(T *_o, void **_a) {
+        using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
+        constexpr auto f = ObjI::method(index<I>).func;
+        using P = QtPrivate::FunctionPointer<std::remove_const_t<decltype(f)>>;
+        P::template call<typename P::Arguments, typename P::ReturnType>(f, _o, _a);
     }
 
-    /// Helper for implementation of qt_static_metacall for QMetaObject::RegisterMethodArgumentMetaType
-    /// T is the class, and I is the index of a method.
-    template <typename T, int I>
-    static void registerMethodArgumentType(int _id, void **_a) {
-        if (_id == I) {
-            using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
-            constexpr auto f = ObjI::method(index<I>).func;
-            using P = QtPrivate::FunctionPointer<std::remove_const_t<decltype(f)>>;
-            auto _t = QtPrivate::ConnectionTypes<typename P::Arguments>::types();
-            uint arg = *reinterpret_cast<uint*>(_a[1]);
-            *reinterpret_cast<int*>(_a[0]) = _t && arg < P::ArgumentCount ?
-                    _t[arg] : -1;
-        }
+    /// Dispatch QMetaObject::InvokeMetaMethod to the method with index _id.
+    /// The invokeMethod thunks are stored in a table indexed by the method index, so the cost
+    /// does not depend on the amount of methods.
+    template <typename T, size_t... MethI>
+    static void invokeMethodById(T *_o, int _id, void **_a, index_sequence<MethI...>) {
+        using Invoker = void (*)(T *, void **);
+        static constexpr Invoker invokers[] = { &invokeMethod<T, MethI>..., nullptr };
+        if (uint(_id) < sizeof...(MethI))
+            invokers[_id](_o, _a);
     }
 
-    /// Helper for implementation of qt_static_metacall for any of the operations in a property
+    /// Helpers for implementation of qt_static_metacall for the operations in a property
     /// T is the class, and I is the index of a property.
     template<typename T, int I>
-    static void propertyOperation(T *_o, QMetaObject::Call _c, int _id, void **_a) {
-        if (_id != I)
-            return;
+    static void readProperty(T *_o, void **_a) {
+        using TPP = T**;
+        constexpr auto p = stateValue<I, PropertyStateTag, TPP>;
+        using Type = typename decltype(p)::PropertyType;
+        if (p.getter) {
+            propGet(p.getter, _o, *reinterpret_cast<Type*>(_a[0]));
+        } else if (p.member) {
+            propGet(p.member, _o, *reinterpret_cast<Type*>(_a[0]));
+        }
+    }
+    template<typename T, int I>
+    static void writeProperty(T *_o, void **_a) {
         using TPP = T**;
-        constexpr auto p = w_state(index<I>, PropertyStateTag{}, TPP{});
+        constexpr auto p = stateValue<I, PropertyStateTag, TPP>;
         using Type = typename decltype(p)::PropertyType;
+        if (p.setter) {
+            propSetValue(p.setter, _o, *reinterpret_cast<Type*>(_a[0]), _a,
+                         SetterTakesRvalue<std::remove_const_t<decltype(p.setter)>>{});
+        } else if (p.member) {
+            // Like moc, only assign and notify if the value changes
+            const Type &value = *reinterpret_cast<Type*>(_a[0]);
+            if (!propEquals(p.member, _o, value, 0)) {
+                propSet(p.member, _o, value);
+                propNotify(p.notify, p.member, _o);
+            }
+        }
+    }
+    template<typename T, int I>
+    static void resetProperty(T *_o, void **) {
+        using TPP = T**;
+        constexpr auto p = stateValue<I, PropertyStateTag, TPP>;
+        if (p.reset) {
+            propReset(p.reset, _o);
+        }
+    }
+
+    /// Dispatch the property operation _c to the property with index _id.
+    /// There is one table of thunks per operation, indexed by the property index, so the cost
+    /// does not depend on the amount of properties.
+    template<typename T, size_t... PropI>
+    static void propertyOperationById(T *_o, QMetaObject::Call _c, int _id, void **_a, index_sequence<PropI...>) {
+        using Operation = void (*)(T *, void **);
+        static constexpr Operation readers[] = { &readProperty<T, PropI>..., nullptr };
+        static constexpr Operation writers[] = { &writeProperty<T, PropI>..., nullptr };
+        static constexpr Operation resetters[] = { &resetProperty<T, PropI>..., nullptr };
+        if (uint(_id) >= sizeof...(PropI))
+            return;
         switch(+_c) {
         case QMetaObject::ReadProperty:
-            if (p.getter) {
-                propGet(p.getter, _o, *reinterpret_cast<Type*>(_a[0]));
-            } else if (p.member) {
-                propGet(p.member, _o, *reinterpret_cast<Type*>(_a[0]));
-            }
+            readers[_id](_o, _a);
             break;
         case QMetaObject::WriteProperty:
-            if (p.setter) {
-                propSet(p.setter, _o, *reinterpret_cast<Type*>(_a[0]));
-            } else if (p.member) {
-                propSet(p.member, _o, *reinterpret_cast<Type*>(_a[0]));
-                propNotify(p.notify, p.member, _o);
-            }
+            writers[_id](_o, _a);
             break;
         case QMetaObject::ResetProperty:
-            if (p.reset) {
-                propReset(p.reset, _o);
-            }
+            resetters[_id](_o, _a);
             break;
         case QMetaObject::RegisterPropertyMetaType:
-            *reinterpret_cast<int*>(_a[0]) = QtPrivate::QMetaTypeIdHelper<Type>::qt_metatype_id();
+            *reinterpret_cast<int*>(_a[0]) = PropertyTypes<T, index_sequence<PropI...>>::metaType(_id);
+            break;
         }
     }
 
@@ -949,7 +1199,7 @@ QT_WARNING_POP
     static void createInstance(int _id, void** _a) {
         if (_id == I) {
             using TPP = T**;
-            constexpr auto m = w_state(index<I>, ConstructorStateTag{}, TPP{});
+            constexpr auto m = stateValue<I, ConstructorStateTag, TPP>;
             createInstanceImpl<T>(_a, m, m.argSequence);
         }
     }
@@ -962,25 +1212,12 @@ QT_WARNING_POP
         Q_UNUSED(_id) Q_UNUSED(_o) Q_UNUSED(_a)
         if (_c == QMetaObject::InvokeMetaMethod) {
             Q_ASSERT(T::staticMetaObject.cast(_o));
-#if __cplusplus > 201700L
-            (invokeMethod<T, MethI>(reinterpret_cast<T*>(_o), _id, _a),...);
-#else
-            ordered((invokeMethod<T, MethI>(reinterpret_cast<T*>(_o), _id, _a),0)...);
-#endif
+            invokeMethodById<T>(reinterpret_cast<T*>(_o), _id, _a, index_sequence<MethI...>{});
         } else if (_c == QMetaObject::RegisterMethodArgumentMetaType) {
-#if __cplusplus > 201700L
-            (registerMethodArgumentType<T,MethI>(_id, _a),...);
-#else
-            ordered((registerMethodArgumentType<T,MethI>(_id, _a),0)...);
-#endif
+            *reinterpret_cast<int*>(_a[0]) = MethodArgumentTypes<T, index_sequence<MethI...>>::metaType(
+                _id, *reinterpret_cast<uint*>(_a[1]));
         } else if (_c == QMetaObject::IndexOfMethod) {
-#if __cplusplus > 201700L
-            *reinterpret_cast<int *>(_a[0]) = ((1+indexOfMethod<T,MethI>(reinterpret_cast<void **>(_a[1]))) + ... + 0)-1;
-#else
-            auto r = int{-1};
-            ordered2<int>({(r += (1+indexOfMethod<T,MethI>(reinterpret_cast<void **>(_a[1]))))...});
-            *reinterpret_cast<int *>(_a[0]) = r;
-#endif
+            *reinterpret_cast<int *>(_a[0]) = SignalIndexOf<T>::value(reinterpret_cast<void **>(_a[1]));
         } else if (_c == QMetaObject::CreateInstance) {
 #if __cplusplus > 201700L
             (createInstance<T, ConsI>(_id, _a),...);
@@ -989,11 +1226,7 @@ QT_WARNING_POP
 #endif
         } else if ((_c >= QMetaObject::ReadProperty && _c <= QMetaObject::QueryPropertyUser)
                 || _c == QMetaObject::RegisterPropertyMetaType) {
-#if __cplusplus > 201700L
-            (propertyOperation<T,PropI>(static_cast<T*>(_o), _c, _id, _a),...);
-#else
-            ordered((propertyOperation<T,PropI>(static_cast<T*>(_o), _c, _id, _a),0)...);
-#endif
+            propertyOperationById<T>(static_cast<T*>(_o), _c, _id, _a, index_sequence<PropI...>{});
         }
     }
 
@@ -1003,17 +1236,10 @@ QT_WARNING_POP
                             std::index_sequence<MethI...>, std::index_sequence<ConsI...>, std::index_sequence<PropI...>) {
         Q_UNUSED(_id) Q_UNUSED(_o) Q_UNUSED(_a)
         if (_c == QMetaObject::InvokeMetaMethod) {
-#if __cplusplus > 201700L
-            (invokeMethod<T, MethI>(_o, _id, _a),...);
-#else
-            ordered((invokeMethod<T, MethI>(_o, _id, _a), 0)...);
-#endif
+            invokeMethodById<T>(_o, _id, _a, index_sequence<MethI...>{});
         } else if (_c == QMetaObject::RegisterMethodArgumentMetaType) {
-#if __cplusplus > 201700L
-            (registerMethodArgumentType<T,MethI>(_id, _a),...);
-#else
-            ordered((registerMethodArgumentType<T,MethI>(_id, _a), 0)...);
-#endif
+            *reinterpret_cast<int*>(_a[0]) = MethodArgumentTypes<T, index_sequence<MethI...>>::metaType(
+                _id, *reinterpret_cast<uint*>(_a[1]));
         } else if (_c == QMetaObject::IndexOfMethod) {
             Q_ASSERT_X(false, "qt_static_metacall", "IndexOfMethod called on a Q_GADGET");
         } else if (_c == QMetaObject::CreateInstance) {
@@ -1024,11 +1250,7 @@ QT_WARNING_POP
 #endif
         } else if ((_c >= QMetaObject::ReadProperty && _c <= QMetaObject::QueryPropertyUser)
                 || _c == QMetaObject::RegisterPropertyMetaType) {
-#if __cplusplus > 201700L
-            (propertyOperation<T,PropI>(_o, _c, _id, _a),...);
-#else
-            ordered((propertyOperation<T,PropI>(_o, _c, _id, _a), 0)...);
-#endif
+            propertyOperationById<T>(_o, _c, _id, _a, index_sequence<PropI...>{});
         }
     }
 
@@ -1044,27 +1266,541 @@ QT_WARNING_POP
     static void* qt_metacast_impl(T *o, const char *_clname) {
         if (!_clname)
             return nullptr;
-        const QByteArrayDataPtr sd = { const_cast<QByteArrayData*>(T::staticMetaObject.d.stringdata) };
-        if (_clname == QByteArray(sd))
-            return o;
         using ObjI = typename T::W_MetaObjectCreatorHelper::ObjectInfo;
-        void *result = {};
-        auto l = [&](auto i) {
-            using TPP = T**;
-            using Interface = decltype(w_state(i, InterfaceStateTag{}, TPP{}));
-            const char *iid = qobject_interface_iid<Interface>();
-            if (iid && !strcmp(_clname, iid))
-                result = static_cast<Interface>(o);
-        };
-        fold(ObjI::interfaceSequence, l);
-        if (!result) return o->T::W_BaseType::qt_metacast(_clname);
-        return result;
+        // Compare with the class name without going through the QByteArray in the string data
+        constexpr auto name = ObjI::name;
+        if (!strncmp(_clname, name.b, size_t(name.size())) && _clname[name.size()] == '\0')
+            return o;
+        if (void *result = InterfaceTable<T, std::remove_const_t<decltype(ObjI::interfaceSequence)>>::cast(o, _clname))
+            return result;
+        return o->T::W_BaseType::qt_metacast(_clname);
+    }
+
+    /// Give access to the protected QObject::isSignalConnected for w_isConnected
+    template<typename T>
+    static bool isSignalConnected(const T *o, const QMetaMethod &signal) {
+        return o->isSignalConnected(signal);
     }
 
 }; // FriendHelper
 
 } // namespace w_internal
 
+/// Returns true if something is connected to the signal of the object obj.
+/// This is meant to avoid computing expensive arguments of a signal that nobody listens to:
+/// emitting a signal already checks if it is connected before doing anything.
+/// Example: `if (w_isConnected(this, &MyObject::dataChanged)) emit dataChanged(computeData());`
+template<typename Obj, typename Func>
+bool w_isConnected(const Obj *obj, Func signal) {
+    using SignalObj = typename QtPrivate::FunctionPointer<Func>::Object;
+    return w_internal::FriendHelper::isSignalConnected<SignalObj>(obj, QMetaMethod::fromSignal(signal));
+}
+
+#if __cplusplus > 201700L
+/// Same as w_isConnected(obj, Signal), but the QMetaMethod of the signal is only looked up once.
+/// Example: `if (w_isConnected<&MyObject::dataChanged>(this)) emit dataChanged(computeData());`
+template<auto Signal, typename Obj>
+bool w_isConnected(const Obj *obj) {
+    using SignalObj = typename QtPrivate::FunctionPointer<decltype(Signal)>::Object;
+    static const QMetaMethod signal = QMetaMethod::fromSignal(Signal);
+    return w_internal::FriendHelper::isSignalConnected<SignalObj>(obj, signal);
+}
+#endif
+
+namespace w_internal {
+/// Compare a StringView with a string of the given size
+constexpr bool stringEquals(StringView s, const char *str, size_t size) {
+    if (size_t(s.size()) != size)
+        return false;
+    for (size_t i = 0; i < size; ++i) {
+        if (s.b[i] != str[i])
+            return false;
+    }
+    return true;
+}
+
+/// Length of a null terminated string, usable in constant expressions
+constexpr size_t stringLength(const char *s) {
+    auto n = size_t{};
+    while (s[n])
+        ++n;
+    return n;
+}
+
+/// Seeded FNV-1a hash, followed by a final mix so that the low bits depend on all the characters
+constexpr uint hashName(const char *s, size_t size, uint seed) {
+    auto h = uint{2166136261u} ^ (seed * 0x9e3779b9u);
+    for (size_t i = 0; i < size; ++i)
+        h = (h ^ uchar(s[i])) * 16777619u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    return h ^ (h >> 15);
+}
+
+/// The smallest power of two which is at least twice n
+constexpr size_t nameHashTableSize(size_t n) {
+    auto m = size_t{1};
+    while (m < 2 * n)
+        m *= 2;
+    return m;
+}
+
+/// Hash table of N names, built at compile time with open addressing: each name is stored in the
+/// first free slot from its hash, and a lookup probes the slots from the hash until an empty one.
+/// This is not a perfect hash: names whose probes overlap are compared one after the other.
+/// A name which is repeated is stored once per index, and the probes find its indexes from the
+/// last to the first, which is the order in which QMetaObject searches the members of a class.
+/// The tables are only used by w_indexOfProperty, w_indexOfEnum and w_indexOfMethod; the
+/// lookups done by QMetaObject itself still go through its linear search.
+template<size_t N>
+struct NameHashTable {
+    static constexpr size_t M = nameHashTableSize(N);
+    static_assert(M > N, "There must be an empty slot to end the probes");
+    StringView names[N ? N : 1]{};
+    int entries[M]{}; // 1 + the index of the name in each slot, or 0 for an empty slot
+    uint seed = 0;
+    size_t longestProbe = 0;
+
+    /// The slot where the probes for the name start
+    constexpr size_t firstSlot(const char *name, size_t size) const {
+        return hashName(name, size, seed) & (M - 1);
+    }
+    /// Returns the index of the next name equal to 'name' from 'slot', and moves 'slot' after
+    /// it so the next call continues the probes. Returns -1 if there is no more such name.
+    /// The indexes are returned in decreasing order.
+    constexpr int next(size_t &slot, const char *name, size_t size) const {
+        for (; entries[slot]; slot = (slot + 1) & (M - 1)) {
+            const int i = entries[slot] - 1;
+            if (stringEquals(names[i], name, size)) {
+                slot = (slot + 1) & (M - 1);
+                return i;
+            }
+        }
+        return -1;
+    }
+    /// Returns the last index of the name, or -1
+    constexpr int find(const char *name, size_t size) const {
+        auto slot = firstSlot(name, size);
+        return next(slot, name, size);
+    }
+    /// Returns the last index of the name in [first, last), or -1
+    constexpr int find(const char *name, size_t size, int first, int last) const {
+        auto slot = firstSlot(name, size);
+        for (int i = next(slot, name, size); i >= 0; i = next(slot, name, size)) {
+            if (i >= first && i < last)
+                return i;
+        }
+        return -1;
+    }
+};
+
+/// Any seed gives a valid table, so only a few of them are tried and the one with the shortest
+/// longest probe is kept. Each attempt is linear in the amount of names. The names are inserted
+/// from the last one, so that the probes meet the repeated names by decreasing index.
+constexpr uint nameHashSeedAttempts = 4;
+
+template<size_t N>
+constexpr NameHashTable<N> makeNameHashTable(const StringViewArray<N> &names) {
+    using Table = NameHashTable<N>;
+    constexpr size_t M = Table::M;
+    auto best = Table{};
+    best.longestProbe = M + 1;
+    for (uint seed = 0; seed < nameHashSeedAttempts && best.longestProbe > 1; ++seed) {
+        auto r = Table{};
+        r.seed = seed;
+        for (size_t i = N; i-- > 0;) {
+            r.names[i] = names[i];
+            auto slot = r.firstSlot(names[i].b, size_t(names[i].size()));
+            auto probe = size_t{1};
+            for (; r.entries[slot]; slot = (slot + 1) & (M - 1))
+                ++probe;
+            r.entries[slot] = int(i) + 1;
+            if (probe > r.longestProbe)
+                r.longestProbe = probe;
+        }
+        if (r.longestProbe < best.longestProbe)
+            best = r;
+    }
+    return best;
+}
+
+/// The names of the properties of T, in order
+template<typename T, size_t... I>
+constexpr auto propertyNames(index_sequence<I...>) {
+    return StringViewArray<sizeof...(I)>{{ stateValue<I, PropertyStateTag, T**>.name... }};
+}
+
+/// The names of the enums of T, followed by their aliases if AliasI is not empty. An enum
+/// without alias has its name as alias, like in the meta data.
+template<typename T, size_t... I, size_t... AliasI>
+constexpr auto enumNames(index_sequence<I...>, index_sequence<AliasI...>) {
+    return StringViewArray<sizeof...(I) + sizeof...(AliasI)>{{ stateValue<I, EnumStateTag, T**>.name...,
+        (stateValue<AliasI, EnumStateTag, T**>.hasAlias ? stateValue<AliasI, EnumStateTag, T**>.alias
+                                                        : stateValue<AliasI, EnumStateTag, T**>.name)... }};
+}
+
+/// The names of the methods of T, in the order of the meta object: signals, slots, then methods
+template<typename T, size_t... SignalI, size_t... SlotI, size_t... MethodI>
+constexpr auto methodNames(index_sequence<SignalI...>, index_sequence<SlotI...>, index_sequence<MethodI...>) {
+    return StringViewArray<sizeof...(SignalI) + sizeof...(SlotI) + sizeof...(MethodI)>{{
+        stateValue<SignalI, SignalStateTag, T**>.name..., stateValue<SlotI, SlotStateTag, T**>.name...,
+        stateValue<MethodI, MethodStateTag, T**>.name... }};
+}
+
+/// The hash tables of the names of the properties, enums and methods declared in T.
+/// Each table is only built if it is used.
+template<typename T>
+struct NameTables {
+    static constexpr size_t L = 1024*1024*1024;
+    static constexpr size_t enumCount = stateCount<L, EnumStateTag, T**>;
+    static constexpr bool hasAlias = QT_VERSION >= QT_VERSION_CHECK(5, 12, 0);
+    using PropertyTable = NameHashTable<stateCount<L, PropertyStateTag, T**>>;
+    using EnumTable = NameHashTable<hasAlias ? 2 * enumCount : enumCount>;
+    using MethodTable = NameHashTable<stateCount<L, SignalStateTag, T**> + stateCount<L, SlotStateTag, T**>
+                                      + stateCount<L, MethodStateTag, T**>>;
+
+    static constexpr PropertyTable properties = makeNameHashTable(
+            propertyNames<T>(make_index_sequence<stateCount<L, PropertyStateTag, T**>>{}));
+    /// The names of the enums are followed by their aliases, like in QMetaObject::indexOfEnumerator
+    static constexpr EnumTable enums = makeNameHashTable(enumNames<T>(
+            make_index_sequence<enumCount>{}, make_index_sequence<hasAlias ? enumCount : 0>{}));
+    static constexpr MethodTable methods = makeNameHashTable(methodNames<T>(
+            make_index_sequence<stateCount<L, SignalStateTag, T**>>{},
+            make_index_sequence<stateCount<L, SlotStateTag, T**>>{},
+            make_index_sequence<stateCount<L, MethodStateTag, T**>>{}));
+};
+#if __cplusplus < 201700L
+template<typename T>
+constexpr typename NameTables<T>::PropertyTable NameTables<T>::properties;
+template<typename T>
+constexpr typename NameTables<T>::EnumTable NameTables<T>::enums;
+template<typename T>
+constexpr typename NameTables<T>::MethodTable NameTables<T>::methods;
+#endif
+} // namespace w_internal
+
+namespace w_internal {
+/// Compare the parameter types of the method 'index' of mo with 'params', the part of a normalized
+/// signature after the opening parenthesis. Like QMetaObject, the types are read from the meta
+/// data, so no signature is built.
+inline bool methodParametersEqual(const QMetaObject &mo, int index, const char *params) {
+    const uint *data = mo.d.data;
+    const uint *method = data + data[HeaderMethodData] + uint(index) * MethodEntrySize;
+    const uint argc = method[1];
+    const uint *types = data + method[2] + 1; // after the return type
+    for (uint i = 0; i < argc; ++i) {
+        if (i > 0 && *params++ != ',')
+            return false;
+        const char *typeName;
+        size_t typeSize;
+        if (types[i] & IsUnresolvedType) {
+            const QByteArrayData &str = mo.d.stringdata[types[i] & ~IsUnresolvedType];
+            typeName = static_cast<const char *>(str.data());
+            typeSize = size_t(str.size);
+        } else {
+            typeName = QMetaType::typeName(int(types[i]));
+            if (!typeName)
+                return false;
+            typeSize = qstrlen(typeName);
+        }
+        for (size_t c = 0; c < typeSize; ++c) {
+            if (params[c] != typeName[c])
+                return false;
+        }
+        params += typeSize;
+    }
+    return params[0] == ')' && params[1] == '\0';
+}
+
+/// Index of the last enum declared in T with the given name, or with the given alias if Alias is
+/// true, or -1. In NameTables<T>::enums, the aliases follow the names.
+template<typename T, bool Alias>
+constexpr int indexOfDeclaredEnum(const char *name, size_t size) {
+    const int count = int(NameTables<T>::enumCount);
+    const int i = NameTables<T>::enums.find(name, size, Alias ? count : 0, Alias ? 2 * count : count);
+    return i >= 0 && Alias ? i - count : i;
+}
+
+/// Index of the method of T with the given normalized signature, or -1. The name is looked up in
+/// the table, then the parameter types of the methods with this name are compared with the signature.
+template<typename T>
+int indexOfMethodSignature(const char *signature) {
+    const auto &methods = NameTables<T>::methods;
+    auto nameSize = size_t{};
+    while (signature[nameSize] && signature[nameSize] != '(')
+        ++nameSize;
+    if (signature[nameSize] != '(')
+        return -1;
+    auto slot = methods.firstSlot(signature, nameSize);
+    for (int i = methods.next(slot, signature, nameSize); i >= 0; i = methods.next(slot, signature, nameSize)) {
+        if (methodParametersEqual(T::staticMetaObject, i, signature + nameSize + 1))
+            return i;
+    }
+    return -1;
+}
+
+/// Lookup of the members of T by name, relative to Root: the first base class of T which is
+/// not a Verdigris object (see MetaCallChain). Like QMetaObject, the members of T are searched
+/// before the ones of the Verdigris classes in between, each with its NameTables, and the last
+/// member with the name is found. The names of the enums are searched in all these classes before
+/// their aliases; an alias is still found before an enum name of Root, which is only looked up
+/// when converting the index to int.
+/// The properties and enums can be looked up at compile time. A W_GADGET has no base class, so
+/// Root is void.
+template<typename T, typename = void>
+struct MemberLookup {
+    using Root = void;
+    static constexpr int methodOffset = 0;
+    static constexpr int propertyOffset = 0;
+    static constexpr int enumOffset = 0;
+    static constexpr int indexOfProperty(const char *name, size_t size) {
+        return NameTables<T>::properties.find(name, size);
+    }
+    template<bool Alias>
+    static constexpr int indexOfEnumIn(const char *name, size_t size) {
+        return indexOfDeclaredEnum<T, Alias>(name, size);
+    }
+    static constexpr int indexOfEnum(const char *name, size_t size) {
+        return indexOfEnumIn<false>(name, size) >= 0 ? indexOfEnumIn<false>(name, size)
+                                                     : indexOfEnumIn<true>(name, size);
+    }
+    static int indexOfMethod(const char *signature) {
+        return indexOfMethodSignature<T>(signature);
+    }
+};
+template<typename T>
+struct MemberLookup<T, std::enable_if_t<std::is_class<typename T::W_BaseType>::value>> {
+    using Chain = MetaCallChain<T>;
+    using Base = typename T::W_BaseType;
+    using Root = typename Chain::Root;
+    using BaseInChain = IsVerdigrisObject<Base>;
+    static constexpr int methodOffset = Chain::methodOffset;
+    static constexpr int propertyOffset = Chain::propertyOffset;
+    static constexpr int enumOffset = Chain::enumOffset;
+
+    static constexpr int indexOfProperty(const char *name, size_t size) {
+        const int i = NameTables<T>::properties.find(name, size);
+        return i >= 0 ? Chain::propertyOffset + i : indexOfPropertyInBase(name, size, BaseInChain{});
+    }
+    template<bool Alias>
+    static constexpr int indexOfEnumIn(const char *name, size_t size) {
+        const int i = indexOfDeclaredEnum<T, Alias>(name, size);
+        return i >= 0 ? Chain::enumOffset + i : indexOfEnumInBase<Alias>(name, size, BaseInChain{});
+    }
+    static constexpr int indexOfEnum(const char *name, size_t size) {
+        return indexOfEnumIn<false>(name, size) >= 0 ? indexOfEnumIn<false>(name, size)
+                                                     : indexOfEnumIn<true>(name, size);
+    }
+    static int indexOfMethod(const char *signature) {
+        const int i = indexOfMethodSignature<T>(signature);
+        return i >= 0 ? Chain::methodOffset + i : indexOfMethodInBase(signature, BaseInChain{});
+    }
+
+private:
+    static constexpr int indexOfPropertyInBase(const char *name, size_t size, std::true_type) {
+        return MemberLookup<Base>::indexOfProperty(name, size);
+    }
+    static constexpr int indexOfPropertyInBase(const char *, size_t, std::false_type) { return -1; }
+    template<bool Alias>
+    static constexpr int indexOfEnumInBase(const char *name, size_t size, std::true_type) {
+        return MemberLookup<Base>::template indexOfEnumIn<Alias>(name, size);
+    }
+    template<bool>
+    static constexpr int indexOfEnumInBase(const char *, size_t, std::false_type) { return -1; }
+    static int indexOfMethodInBase(const char *signature, std::true_type) {
+        return MemberLookup<Base>::indexOfMethod(signature);
+    }
+    static int indexOfMethodInBase(const char *, std::false_type) { return -1; }
+};
+
+enum class MemberKind { Method, Property, Enum };
+} // namespace w_internal
+
+/// Index of a method, property or enum in a meta object, returned by w_indexOfMethod,
+/// w_indexOfProperty and w_indexOfEnum.
+/// 'relative' is the index relative to Root (see MemberLookup), or -1 if the member is not declared
+/// in T or in its Verdigris base classes. It is computed at compile time when the name is a constant.
+/// Converting to int adds the amount of members of Root, which is only known at run time, except
+/// for W_GADGET, where the conversion is a constant expression. If the member was looked up by
+/// name and not found, the conversion looks the name up in the meta object of Root, so the name
+/// must still be valid.
+/// Example:
+/// \code
+///   // The lookup is done at compile time...
+///   constexpr auto valueIndex = w_indexOfProperty<Obj>("value");
+///   static_assert(valueIndex.isValid(), "no property 'value'");
+///   // ...but the absolute index is computed at run time, when converting to int
+///   const int absoluteIndex = valueIndex;
+///   QMetaProperty p = Obj::staticMetaObject.property(absoluteIndex);
+/// \endcode
+template<typename Root, w_internal::MemberKind Kind>
+struct w_MemberIndex {
+    int relative;
+    const char *name = nullptr;
+    constexpr bool isValid() const { return relative >= 0; }
+    operator int() const {
+        const QMetaObject &mo = Root::staticMetaObject;
+        if (relative < 0) {
+            if (!name)
+                return -1;
+            return Kind == w_internal::MemberKind::Method ? mo.indexOfMethod(name)
+                 : Kind == w_internal::MemberKind::Property ? mo.indexOfProperty(name)
+                 : mo.indexOfEnumerator(name);
+        }
+        return relative + (Kind == w_internal::MemberKind::Method ? mo.methodCount()
+                         : Kind == w_internal::MemberKind::Property ? mo.propertyCount()
+                         : mo.enumeratorCount());
+    }
+};
+template<w_internal::MemberKind Kind>
+struct w_MemberIndex<void, Kind> {
+    int relative;
+    const char *name = nullptr;
+    constexpr bool isValid() const { return relative >= 0; }
+    constexpr operator int() const { return relative; }
+};
+
+/// Same as T::staticMetaObject.indexOfProperty(name), but the properties declared with W_PROPERTY
+/// in T and its Verdigris base classes are found with a hash table built at compile time, and the
+/// lookup itself is done at compile time if the name is a constant. The properties of the other
+/// base classes, like QObject::objectName, are looked up by QMetaObject when converting to int.
+template<typename T>
+constexpr auto w_indexOfProperty(const char *name) {
+    using Lookup = w_internal::MemberLookup<T>;
+    return w_MemberIndex<typename Lookup::Root, w_internal::MemberKind::Property>{
+            Lookup::indexOfProperty(name, w_internal::stringLength(name)), name};
+}
+
+/// Same as T::staticMetaObject.indexOfEnumerator(name), with the lookup of w_indexOfProperty
+/// among the enums declared with W_ENUM or W_FLAG. The alias of an enum is also found.
+template<typename T>
+constexpr auto w_indexOfEnum(const char *name) {
+    using Lookup = w_internal::MemberLookup<T>;
+    return w_MemberIndex<typename Lookup::Root, w_internal::MemberKind::Enum>{
+            Lookup::indexOfEnum(name, w_internal::stringLength(name)), name};
+}
+
+/// Same as T::staticMetaObject.indexOfMethod(signature), with the lookup of w_indexOfProperty
+/// on the name of the method, followed by a comparison of the parameter types with the meta
+/// data. This is only done at run time. The signature must be normalized.
+template<typename T>
+auto w_indexOfMethod(const char *signature) {
+    using Lookup = w_internal::MemberLookup<T>;
+    return w_MemberIndex<typename Lookup::Root, w_internal::MemberKind::Method>{
+            Lookup::indexOfMethod(signature), signature};
+}
+
+/// Index of the method F in the meta object of the class which declares it and of its derived
+/// classes, like QMetaObject::indexOfMethod, but without any lookup of the signature.
+/// F must be declared with W_SIGNAL, W_SLOT or W_INVOKABLE.
+/// Example: `w_indexOfMethod<decltype(&Obj::mySlot), &Obj::mySlot>()`
+template<typename F, F f>
+constexpr auto w_indexOfMethod() {
+    using T = typename QtPrivate::FunctionPointer<F>::Object;
+    using Lookup = w_internal::MemberLookup<T>;
+    constexpr int i = w_internal::indexOfMethod<T, F, f>();
+    static_assert(i >= 0, "The method must be declared with W_SIGNAL, W_SLOT or W_INVOKABLE");
+    return w_MemberIndex<typename Lookup::Root, w_internal::MemberKind::Method>{Lookup::methodOffset + i};
+}
+
+#if __cplusplus > 201700L
+/// Same as above, with the type of the pointer to member function deduced.
+/// Example: `w_indexOfMethod<&Obj::mySlot>()`
+template<auto f>
+constexpr auto w_indexOfMethod() {
+    return w_indexOfMethod<decltype(f), f>();
+}
+#endif
+
+namespace w_internal {
+/// The class of the Verdigris chain of T (see MemberLookup) which declares the property with the
+/// index I relative to Root, and the index of the property in that class
+template<typename T, int I, bool = (I >= MemberLookup<T>::propertyOffset)>
+struct PropertyDeclarer {
+    using Type = T;
+    static constexpr int index = I - MemberLookup<T>::propertyOffset;
+};
+template<typename T, int I>
+struct PropertyDeclarer<T, I, false> : PropertyDeclarer<typename T::W_BaseType, I> {};
+} // namespace w_internal
+
+/// Typed access to a property declared with W_PROPERTY in T or in its Verdigris base classes,
+/// without QVariant. I is the index found by w_indexOfProperty, which has to be passed as its
+/// 'relative' member since the index type cannot be a template argument before C++20.
+/// get() calls the getter or reads the member, and set() calls the setter or writes the member
+/// and emits its NOTIFY signal if the value changed, like WriteProperty does.
+/// Example: `w_property<Obj, w_indexOfProperty<Obj>("value").relative>::get(&obj)`
+template<typename T, int I>
+struct w_property {
+private:
+    static_assert(I >= 0, "No such property");
+    using Declarer = w_internal::PropertyDeclarer<T, (I < 0 ? 0 : I)>;
+    using TPP = typename Declarer::Type**;
+    static constexpr auto info() W_RETURN(w_state(w_internal::index<Declarer::index>, w_internal::PropertyStateTag{}, TPP{}))
+    using Info = decltype(info());
+
+    template<typename G, typename M, typename O>
+    static auto read(G getter, M, O *o) W_RETURN((o->*getter)())
+    template<typename M, typename O>
+    static auto read(w_internal::Empty, M member, O *o) W_RETURN(o->*member)
+    // Whether the property can be read from a const object: a MEMBER property or a const getter
+    template<typename O>
+    static auto readableFromConst(O *o) -> decltype(read(info().getter, info().member, o), std::true_type{});
+    static std::false_type readableFromConst(...);
+
+    template<typename S, typename M, typename N, typename V>
+    static void write(S setter, M, N, T *o, V &&value) { (o->*setter)(std::forward<V>(value)); }
+    template<typename M, typename N, typename V>
+    static void write(w_internal::Empty, M member, N notify, T *o, V &&value) {
+        if (!w_internal::propEquals(member, o, value, 0)) {
+            o->*member = std::forward<V>(value);
+            w_internal::propNotify(notify, member, o);
+        }
+    }
+
+public:
+    using Type = typename Info::PropertyType;
+
+    /// The name of the property, as a null terminated string
+    static constexpr const char *name() { return info().name.b; }
+
+    static Type get(const T *obj) {
+        static_assert(Info::flags & uint(w_internal::PropertyFlags::Readable), "The property is not readable");
+        static_assert(decltype(readableFromConst(obj))::value,
+                      "The getter of the property is not const, it can only be called on a non-const object");
+        constexpr auto p = info();
+        return read(p.getter, p.member, obj);
+    }
+    /// Same as above, but the getter does not need to be const
+    static Type get(T *obj) {
+        static_assert(Info::flags & uint(w_internal::PropertyFlags::Readable), "The property is not readable");
+        constexpr auto p = info();
+        return read(p.getter, p.member, obj);
+    }
+
+    static void set(T *obj, Type value) {
+        static_assert(Info::flags & uint(w_internal::PropertyFlags::Writable), "The property is not writable");
+        constexpr auto p = info();
+        write(p.setter, p.member, p.notify, obj, std::move(value));
+    }
+};
+
+namespace w_internal {
+template<typename T, typename F, size_t... I>
+void forEachProperty(F &&f, index_sequence<I...>) {
+    ordered2<int>({(f(w_property<T, MemberLookup<T>::propertyOffset + int(I)>{}), 0)...});
+}
+} // namespace w_internal
+
+/// Calls f with a w_property<T, I> for each property declared with W_PROPERTY in T, in order.
+/// The properties of the base classes are not included.
+/// Example: `w_forEachProperty<Obj>([&](auto prop) { qDebug() << prop.name() << prop.get(&obj); });`
+template<typename T, typename F>
+void w_forEachProperty(F &&f) {
+    w_internal::forEachProperty<T>(f,
+        w_internal::make_index_sequence<w_internal::stateCount<1024*1024*1024, w_internal::PropertyStateTag, T**>>{});
+}
+
 #ifndef QT_INIT_METAOBJECT // Defined in qglobal.h since Qt 5.10
 #define QT_INIT_METAOBJECT
 #endif
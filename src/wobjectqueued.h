@@ -0,0 +1,476 @@
+/****************************************************************************
+ *  Copyright (C) 2016-2018 Woboq GmbH
+ *  Olivier Goffart <ogoffart at woboq.com>
+ *  https://woboq.com/
+ *
+ *  This file is part of Verdigris: a way to use Qt without moc.
+ *  https://github.com/woboq/verdigris
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// w_connectQueued: queued connections which share one queue per receiver thread.
+// This header is not included by wobjectdefs.h nor wobjectimpl.h, include it where
+// w_connectQueued is used.
+
+#include "wobjectdefs.h"
+#include <QtCore/qobject.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qthread.h>
+#include <cstddef>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+namespace w_internal {
+
+/// A call stored in a ThreadCallQueue. The record holding the channel and the arguments is
+/// constructed in place when it is small enough, so that pushing a call does not allocate.
+class QueuedCall {
+    enum Operation { Deliver, Destroy };
+    using ImplFn = void (*)(Operation, QueuedCall *);
+    ImplFn impl = nullptr;
+    alignas(std::max_align_t) unsigned char storage[64];
+
+    template<typename Record>
+    static constexpr bool fitsInline() {
+        return sizeof(Record) <= sizeof(storage) && alignof(Record) <= alignof(std::max_align_t);
+    }
+    template<typename Record>
+    Record *record() {
+        if (fitsInline<Record>())
+            return reinterpret_cast<Record *>(storage);
+        return *reinterpret_cast<Record **>(storage);
+    }
+    template<typename Record>
+    static void implFor(Operation op, QueuedCall *self) {
+        Record *r = self->record<Record>();
+        if (op == Deliver) {
+            r->deliver();
+        } else if (fitsInline<Record>()) {
+            r->~Record();
+        } else {
+            delete r;
+        }
+    }
+
+public:
+    template<typename Record, typename... Args>
+    void construct(Args &&... args) {
+        if (fitsInline<Record>())
+            new (storage) Record{std::forward<Args>(args)...};
+        else
+            *reinterpret_cast<Record **>(storage) = new Record{std::forward<Args>(args)...};
+        impl = &implFor<Record>;
+    }
+    void deliver() { impl(Deliver, this); }
+    void destroy() { impl(Destroy, this); }
+};
+
+/// One segment of a ThreadCallQueue: a ring of calls with several producers and a single consumer,
+/// which does not lock. Each cell has a sequence number telling if it is free for the producer at a
+/// given position, or if it holds the call of that position for the consumer.
+/// Once closed, the segment refuses new calls and the consumer moves to the next segment after
+/// the calls pushed before the closing.
+class CallSegment {
+    struct Cell {
+        QAtomicInteger<quintptr> sequence;
+        QueuedCall call;
+    };
+    static constexpr quintptr ClosedBit = quintptr(1) << (sizeof(quintptr) * 8 - 1);
+    const quintptr mask;
+    Cell *const cells;
+    QAtomicInteger<quintptr> enqueuePos;
+    quintptr dequeuePos = 0; // only used by the consumer
+
+public:
+    QAtomicPointer<CallSegment> next;
+
+    /// The capacity must be a power of two
+    explicit CallSegment(quintptr capacity) : mask(capacity - 1), cells(new Cell[capacity]) {
+        for (quintptr i = 0; i < capacity; ++i)
+            cells[i].sequence.storeRelease(i);
+    }
+    CallSegment(const CallSegment &) = delete;
+    CallSegment &operator=(const CallSegment &) = delete;
+    ~CallSegment() {
+        while (QueuedCall *call = front()) {
+            call->destroy();
+            pop();
+        }
+        delete[] cells;
+    }
+
+    quintptr capacity() const { return mask + 1; }
+
+    /// Constructs a Record from args at the end of the segment. Returns false if the segment
+    /// is full or closed. Can be called from any thread.
+    template<typename Record, typename... Args>
+    bool tryPush(Args &&... args) {
+        auto pos = enqueuePos.loadAcquire();
+        for (;;) {
+            if (pos & ClosedBit)
+                return false;
+            Cell &cell = cells[pos & mask];
+            const auto diff = qintptr(cell.sequence.loadAcquire() - pos);
+            if (diff == 0) {
+                // Fails if the segment was closed meanwhile, as the closed bit changes enqueuePos
+                if (enqueuePos.testAndSetRelaxed(pos, pos + 1, pos)) {
+                    cell.call.construct<Record>(std::forward<Args>(args)...);
+                    cell.sequence.storeRelease(pos + 1);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.loadAcquire();
+            }
+        }
+    }
+
+    /// No call can be pushed once this returns
+    void close() { enqueuePos.fetchAndOrOrdered(ClosedBit); }
+
+    /// The first call, or nullptr if there is none yet. Must only be called by the consumer.
+    QueuedCall *front() {
+        Cell &cell = cells[dequeuePos & mask];
+        return cell.sequence.loadAcquire() == dequeuePos + 1 ? &cell.call : nullptr;
+    }
+    /// Frees the cell of the first call, which must have been destroyed.
+    /// Must only be called by the consumer.
+    void pop() {
+        cells[dequeuePos & mask].sequence.storeRelease(dequeuePos + mask + 1);
+        ++dequeuePos;
+    }
+    /// Whether the segment is closed and all the calls pushed before are popped.
+    /// Must only be called by the consumer.
+    bool isFinished() const {
+        const auto pos = enqueuePos.loadAcquire();
+        return (pos & ClosedBit) && (pos & ~ClosedBit) == dequeuePos;
+    }
+};
+
+/// The queue shared by all the connections made with w_connectQueued to receivers living in a
+/// given thread. The calls are delivered in order by a single event posted to that thread for the
+/// entire batch of pending calls.
+/// When the last segment is full, a producer closes it and appends a segment twice as big, so the
+/// emitting thread neither waits nor posts an event per call; it only takes a lock to grow the queue.
+class ThreadCallQueue : public QEnableSharedFromThis<ThreadCallQueue> {
+    enum : quintptr { InitialCapacity = 1024, MaximumSegmentCapacity = 64 * 1024 };
+    QThread *const thread;
+    QObject *const context; // lives in thread, receives the drain events
+    CallSegment *head; // only used by the consumer
+    QAtomicPointer<CallSegment> tail;
+    QAtomicInt drainPosted; // 1 when a call to drain() is posted and has not emptied the queue yet
+    QAtomicInt pushing; // the producers which may still use a segment they read from tail
+    CallSegment *retired = nullptr; // finished segments not deleted yet, only used by the consumer
+    QMutex growMutex;
+
+    static QMutex &registryMutex() { static QMutex mutex; return mutex; }
+    static QHash<QThread *, QWeakPointer<ThreadCallQueue>> &registry() {
+        static QHash<QThread *, QWeakPointer<ThreadCallQueue>> queues;
+        return queues;
+    }
+
+    void postDrain() {
+        auto self = this->sharedFromThis();
+        QMetaObject::invokeMethod(context, [self] { self->drain(); }, Qt::QueuedConnection);
+    }
+
+    void grow(CallSegment *full) {
+        QMutexLocker lock(&growMutex);
+        if (tail.loadRelaxed() != full)
+            return; // another producer already did
+        full->close();
+        auto segment = new CallSegment(qMin(full->capacity() * 2, quintptr(MaximumSegmentCapacity)));
+        // Set the tail before linking, so that once the consumer sees the next segment, no
+        // producer can read the full one from tail anymore.
+        tail.storeRelease(segment);
+        full->next.storeRelease(segment);
+    }
+
+    /// The first call, moving to the next segment when the current one is finished.
+    /// Must only be called by the consumer.
+    QueuedCall *front() {
+        for (;;) {
+            if (QueuedCall *call = head->front())
+                return call;
+            CallSegment *next = head->next.loadAcquire();
+            if (!next || !head->isFinished())
+                return nullptr;
+            head->next.storeRelaxed(retired);
+            retired = head;
+            head = next;
+        }
+    }
+
+    /// Deletes the finished segments, when no producer may still be using one of them
+    void deleteRetired() {
+        if (!retired || !pushing.testAndSetOrdered(0, 0))
+            return;
+        while (CallSegment *segment = retired) {
+            retired = segment->next.loadRelaxed();
+            delete segment;
+        }
+    }
+
+    /// Delivers the pending calls, in the thread of the receivers.
+    /// The call is delivered in its cell, which producers only reuse once it is popped. The slot
+    /// can emit again: there is no other drain until this one returns.
+    void drain() {
+        // Do not deliver more than a segment worth of calls for one event, so producers faster
+        // than the slots do not prevent the event loop from processing other events.
+        for (auto n = head->capacity(); n; --n) {
+            if (QueuedCall *call = front()) {
+                call->deliver();
+                call->destroy();
+                head->pop();
+                continue;
+            }
+            deleteRetired();
+            // The queue is empty: let the next push post a drain, then check again for a call
+            // pushed before the flag was cleared, whose push did not post one.
+            drainPosted.fetchAndStoreOrdered(0);
+            if (!front() || !drainPosted.testAndSetOrdered(0, 1))
+                return;
+        }
+        postDrain();
+    }
+
+public:
+    ThreadCallQueue(QThread *thread)
+        : thread(thread), context(new QObject), head(new CallSegment(InitialCapacity)), tail(head) {
+        context->moveToThread(thread);
+    }
+    ThreadCallQueue(const ThreadCallQueue &) = delete;
+    ThreadCallQueue &operator=(const ThreadCallQueue &) = delete;
+    ~ThreadCallQueue() {
+        {
+            QMutexLocker lock(&registryMutex());
+            if (registry().value(thread).isNull())
+                registry().remove(thread);
+        }
+        context->deleteLater();
+        while (CallSegment *segment = head) {
+            head = segment->next.loadRelaxed();
+            delete segment;
+        }
+        while (CallSegment *segment = retired) {
+            retired = segment->next.loadRelaxed();
+            delete segment;
+        }
+    }
+
+    /// The queue of the given thread, created if no connection uses it yet
+    static QSharedPointer<ThreadCallQueue> forThread(QThread *thread) {
+        QMutexLocker lock(&registryMutex());
+        QSharedPointer<ThreadCallQueue> queue = registry().value(thread).toStrongRef();
+        // A new thread may have been created at the address of a deleted one
+        if (!queue || queue->context->thread() != thread) {
+            queue = QSharedPointer<ThreadCallQueue>::create(thread);
+            registry().insert(thread, queue);
+        }
+        return queue;
+    }
+
+    /// Constructs a Record from args at the end of the queue, and posts a drain if none is
+    /// pending. Can be called from any thread.
+    template<typename Record, typename... Args>
+    void push(Args &&... args) {
+        pushing.ref();
+        for (;;) {
+            CallSegment *segment = tail.loadAcquire();
+            // The arguments are only forwarded by the attempt which succeeds
+            if (segment->tryPush<Record>(std::forward<Args>(args)...))
+                break;
+            grow(segment);
+        }
+        pushing.deref();
+        // A store even if a drain is posted, so that drain() sees the call if it is clearing the flag
+        if (!drainPosted.fetchAndStoreOrdered(1))
+            postDrain();
+    }
+};
+
+/// A call of a channel, stored in a ThreadCallQueue
+template<typename Channel, typename Values>
+struct ChannelCall {
+    QSharedPointer<Channel> channel;
+    Values values;
+    void deliver() { channel->deliver(values); }
+};
+
+/// One argument of a call stored by w_connectQueued
+template<size_t I, typename T> struct StoredArgument { T value; };
+
+/// The arguments of a call stored by w_connectQueued, with their decayed types
+template<typename Is, typename... Args> struct StoredArguments;
+template<size_t... I, typename... Args>
+struct StoredArguments<index_sequence<I...>, Args...> : StoredArgument<I, Args>... {
+    StoredArguments() = default;
+    template<typename... A, typename = std::enable_if_t<(sizeof...(A) > 0)>>
+    explicit StoredArguments(const A &... args) : StoredArgument<I, Args>{args}... {}
+};
+template<typename... Args>
+using StoredArgumentsOf = StoredArguments<make_index_sequence<sizeof...(Args)>, std::decay_t<Args>...>;
+
+/// Calls the slot with the arguments stored in values, which are moved if the slot takes them by value
+template<typename SlotFunc, SlotFunc Slot, typename... Args, typename Values, std::size_t... I>
+void callSlot(typename QtPrivate::FunctionPointer<SlotFunc>::Object *receiver, Values &values, index_sequence<I...>) {
+    Q_UNUSED(values)
+    (receiver->*Slot)(static_cast<Args &&>(static_cast<StoredArgument<I, std::decay_t<Args>> &>(values).value)...);
+}
+
+/// Calls the slot in the thread of the receiver. If the receiver was moved to another thread
+/// after the connection was made, the call is posted to it like Qt::QueuedConnection does.
+template<typename SlotFunc, SlotFunc Slot, typename... Args, typename Values>
+void callSlotInReceiverThread(const QPointer<typename QtPrivate::FunctionPointer<SlotFunc>::Object> &receiver,
+                              Values &values) {
+    auto r = receiver.data();
+    if (!r)
+        return;
+    if (r->thread() != QThread::currentThread()) {
+        QMetaObject::invokeMethod(r, [r, values = std::move(values)]() mutable {
+            callSlot<SlotFunc, Slot, Args...>(r, values, make_index_sequence<sizeof...(Args)>{});
+        }, Qt::QueuedConnection);
+        return;
+    }
+    callSlot<SlotFunc, Slot, Args...>(r, values, make_index_sequence<sizeof...(Args)>{});
+}
+
+/// State of a connection made with w_connectQueued, shared with the calls it pushes to the
+/// queue of the receiver's thread
+template<typename SlotFunc, SlotFunc Slot, typename Args = typename QtPrivate::FunctionPointer<SlotFunc>::Arguments>
+class QueuedSlotChannel;
+template<typename SlotFunc, SlotFunc Slot, typename... Args>
+class QueuedSlotChannel<SlotFunc, Slot, QtPrivate::List<Args...>>
+        : public QEnableSharedFromThis<QueuedSlotChannel<SlotFunc, Slot, QtPrivate::List<Args...>>> {
+    using Receiver = typename QtPrivate::FunctionPointer<SlotFunc>::Object;
+    using Values = StoredArgumentsOf<Args...>;
+    QPointer<Receiver> receiver;
+    QSharedPointer<ThreadCallQueue> queue;
+
+public:
+    explicit QueuedSlotChannel(Receiver *receiver)
+        : receiver(receiver), queue(ThreadCallQueue::forThread(receiver->thread())) {}
+
+    /// Called in the thread emitting the signal
+    void push(const std::decay_t<Args> &... args) {
+        queue->push<ChannelCall<QueuedSlotChannel, Values>>(this->sharedFromThis(), Values(args...));
+    }
+
+    void deliver(Values &values) { callSlotInReceiverThread<SlotFunc, Slot, Args...>(receiver, values); }
+};
+
+/// State of a connection made with w_connectQueued to a signal declared with the W_Compressed
+/// flag: there is at most one pending call in the queue, and each emission overwrites its arguments.
+template<typename SlotFunc, SlotFunc Slot, typename Args = typename QtPrivate::FunctionPointer<SlotFunc>::Arguments>
+class CompressedSlotChannel;
+template<typename SlotFunc, SlotFunc Slot, typename... Args>
+class CompressedSlotChannel<SlotFunc, Slot, QtPrivate::List<Args...>>
+        : public QEnableSharedFromThis<CompressedSlotChannel<SlotFunc, Slot, QtPrivate::List<Args...>>> {
+    using Receiver = typename QtPrivate::FunctionPointer<SlotFunc>::Object;
+    using Values = StoredArgumentsOf<Args...>;
+    static_assert(std::is_default_constructible<Values>::value,
+                  "The argument types of the slot must be default constructible to keep the latest ones");
+    QPointer<Receiver> receiver;
+    QSharedPointer<ThreadCallQueue> queue;
+    QMutex mutex;
+    Values pending; // protected by mutex
+    bool hasPending = false; // protected by mutex
+
+public:
+    /// The arguments of the pending call are held by the channel, not by the queue
+    struct Latest {};
+
+    explicit CompressedSlotChannel(Receiver *receiver)
+        : receiver(receiver), queue(ThreadCallQueue::forThread(receiver->thread())) {}
+
+    /// Called in the thread emitting the signal. Only pushes a call if none is pending.
+    void push(const std::decay_t<Args> &... args) {
+        bool post;
+        {
+            QMutexLocker lock(&mutex);
+            pending = Values(args...);
+            post = !hasPending;
+            hasPending = true;
+        }
+        if (post)
+            queue->push<ChannelCall<CompressedSlotChannel, Latest>>(this->sharedFromThis(), Latest{});
+    }
+
+    void deliver(Latest) {
+        Values values;
+        {
+            QMutexLocker lock(&mutex);
+            values = std::move(pending);
+            hasPending = false;
+        }
+        callSlotInReceiverThread<SlotFunc, Slot, Args...>(receiver, values);
+    }
+};
+
+/// Functor connected to the signal by w_connectQueued
+template<typename Channel, typename Args> struct QueuedSlotPush;
+template<typename Channel, typename... Args>
+struct QueuedSlotPush<Channel, QtPrivate::List<Args...>> {
+    QSharedPointer<Channel> channel;
+    void operator()(const std::decay_t<Args> &... args) const { channel->push(args...); }
+};
+} // namespace w_internal
+
+/// Connect the signal Signal of sender to the method Slot of receiver with a queued connection
+/// that does not allocate for each emission.
+/// Qt::QueuedConnection allocates an event and a copy of every argument on the heap for each
+/// emission, and posts the event under the lock of the receiver thread's event queue. This
+/// connection instead copies the arguments into a queue shared by all the connections made with
+/// w_connectQueued to receivers of the same thread, and posts a single event to that thread for
+/// the entire batch of pending calls. The calls with arguments bigger than 64 bytes once copied
+/// are allocated on the heap.
+/// When the queue is full, it grows by a segment twice as big, up to 65536 calls per segment.
+/// The emitting thread never waits, except for the lock taken to grow the queue. The order of the
+/// calls is kept among all the connections of the thread, but not relative to the events posted by
+/// Qt::QueuedConnection.
+/// If the signal is declared with the W_Compressed flag, only the arguments of the latest emission
+/// are kept until the receiver processes them; their types must then be default constructible.
+/// Include wobjectqueued.h to use it.
+/// Example: `w_connectQueued<decltype(&Sender::sig), &Sender::sig, decltype(&Receiver::slot), &Receiver::slot>(sender, receiver)`
+template<typename SignalFunc, SignalFunc Signal, typename SlotFunc, SlotFunc Slot>
+QMetaObject::Connection w_connectQueued(const typename QtPrivate::FunctionPointer<SignalFunc>::Object *sender,
+                                        typename QtPrivate::FunctionPointer<SlotFunc>::Object *receiver) {
+    using SlotType = QtPrivate::FunctionPointer<SlotFunc>;
+    static_assert(SlotType::IsPointerToMemberFunction, "Slot must be a pointer to member function");
+    using SignalObj = typename QtPrivate::FunctionPointer<SignalFunc>::Object;
+    using Channel = std::conditional_t<w_internal::isCompressedSignal<SignalObj, SignalFunc, Signal>(),
+                                       w_internal::CompressedSlotChannel<SlotFunc, Slot>,
+                                       w_internal::QueuedSlotChannel<SlotFunc, Slot>>;
+    return QObject::connect(sender, Signal, receiver,
+                            w_internal::QueuedSlotPush<Channel, typename SlotType::Arguments>{
+                                QSharedPointer<Channel>::create(receiver)},
+                            Qt::DirectConnection);
+}
+
+#if __cplusplus > 201700L
+/// Same as above, with the types of the pointers to member functions deduced.
+/// Example: `w_connectQueued<&Sender::sig, &Receiver::slot>(sender, receiver)`
+template<auto Signal, auto Slot>
+QMetaObject::Connection w_connectQueued(const typename QtPrivate::FunctionPointer<decltype(Signal)>::Object *sender,
+                                        typename QtPrivate::FunctionPointer<decltype(Slot)>::Object *receiver) {
+    return w_connectQueued<decltype(Signal), Signal, decltype(Slot), Slot>(sender, receiver);
+}
+#endif
+#endif // QT_VERSION >= 5.10
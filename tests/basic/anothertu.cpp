@@ -20,6 +20,7 @@
 #include "anothertu.h"
 
 W_GADGET_IMPL(AnotherTU::Gaga)
+W_OBJECT_IMPL(AnotherTU::BaseObject)
 
 #ifdef Q_NAMESPACE // Since Qt 5.8
 W_NAMESPACE_IMPL(AnotherTU)
@@ -46,6 +46,16 @@ public:
     W_PROPERTY(int, foo MEMBER m_foo)
 };
 
+/// Base class whose W_OBJECT_IMPL is in anothertu.cpp, derived in tst_basic.cpp
+struct BaseObject : QObject {
+    W_OBJECT(BaseObject)
+public:
+    int m_base = 1;
+    W_PROPERTY(int, base MEMBER m_base)
+    void setBase(int value) { m_base = value; }
+    W_SLOT(setBase)
+};
+
 #ifdef Q_NAMESPACE // Since Qt 5.8
 W_NAMESPACE(AnotherTU)
 enum ATTestEnum {
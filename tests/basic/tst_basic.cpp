@@ -48,6 +48,42 @@ private slots:
     void signalArgs();
     W_SLOT(signalArgs, W_Access::Private)
 
+    void signalIndex();
+    W_SLOT(signalIndex, W_Access::Private)
+
+    void isConnected();
+    W_SLOT(isConnected, W_Access::Private)
+
+    void signalReturnValue();
+    W_SLOT(signalReturnValue, W_Access::Private)
+
+    void typedConnect();
+    W_SLOT(typedConnect, W_Access::Private)
+
+    void declaredConnections();
+    W_SLOT(declaredConnections, W_Access::Private)
+
+    void queuedChannelConnect();
+    W_SLOT(queuedChannelConnect, W_Access::Private)
+
+    void compressedSignal();
+    W_SLOT(compressedSignal, W_Access::Private)
+
+    void memberPropertyChange();
+    W_SLOT(memberPropertyChange, W_Access::Private)
+
+    void moveAwareSetter();
+    W_SLOT(moveAwareSetter, W_Access::Private)
+
+    void typedPropertyAccess();
+    W_SLOT(typedPropertyAccess, W_Access::Private)
+
+    void compileTimeIndexes();
+    W_SLOT(compileTimeIndexes, W_Access::Private)
+
+    void nameLookup();
+    W_SLOT(nameLookup, W_Access::Private)
+
     void overloadForm();
     W_SLOT(overloadForm,(), W_Access::Private)
 
@@ -77,6 +113,7 @@ private slots:
 };
 
 #include <wobjectimpl.h>
+#include <wobjectqueued.h>
 
 #include <QtTest/QtTest>
 
@@ -189,6 +226,418 @@ void tst_Basic::signalArgs()
     QCOMPARE(method.parameterNames(), (QByteArrayList{ "a", "b", "c" }));
 }
 
+void tst_Basic::signalIndex()
+{
+    QCOMPARE(QMetaMethod::fromSignal(&BTestObj::valueChanged).name(), QByteArray("valueChanged"));
+    QCOMPARE(QMetaMethod::fromSignal(&BTestObj::simpleSignal).name(), QByteArray("simpleSignal"));
+    QCOMPARE(QMetaMethod::fromSignal(&BTestObj::anotherSignal).name(), QByteArray("anotherSignal"));
+    QVERIFY(!QMetaMethod::fromSignal(&BTestObj::resetValue).isValid());
+
+    // QMetaMethod::fromSignal gets the index from QMetaObject::IndexOfMethod
+    const int offset = BTestObj::staticMetaObject.methodOffset();
+    QCOMPARE(QMetaMethod::fromSignal(&BTestObj::simpleSignal).methodIndex(), offset + 1);
+    QCOMPARE(QMetaMethod::fromSignal(&BTestObj::anotherSignal).methodIndex(), offset + 3);
+}
+
+void tst_Basic::isConnected()
+{
+    BTestObj obj;
+    QVERIFY(!w_isConnected(&obj, &BTestObj::simpleSignal));
+    auto c = connect(&obj, &BTestObj::simpleSignal, [] {});
+    QVERIFY(w_isConnected(&obj, &BTestObj::simpleSignal));
+    QVERIFY(!w_isConnected(&obj, &BTestObj::anotherSignal));
+#if __cplusplus > 201700L
+    QVERIFY(w_isConnected<&BTestObj::simpleSignal>(&obj));
+    QVERIFY(!w_isConnected<&BTestObj::anotherSignal>(&obj));
+#endif
+    disconnect(c);
+    QVERIFY(!w_isConnected(&obj, &BTestObj::simpleSignal));
+
+    // emitting while the signals are blocked does not reach the slots
+    int count = 0;
+    connect(&obj, &BTestObj::simpleSignal, [&count] { ++count; });
+    obj.blockSignals(true);
+    emit obj.simpleSignal();
+    QCOMPARE(count, 0);
+    obj.blockSignals(false);
+    emit obj.simpleSignal();
+    QCOMPARE(count, 1);
+}
+
+class ReturnSignalObj : public QObject
+{   W_OBJECT(ReturnSignalObj)
+public:
+    int intQuery(int x) W_SIGNAL(intQuery, x)
+    QString stringQuery() const W_SIGNAL(stringQuery)
+};
+
+W_OBJECT_IMPL(ReturnSignalObj)
+
+void tst_Basic::signalReturnValue()
+{
+    ReturnSignalObj obj;
+    // Without slot, the value is value-initialized
+    QCOMPARE(obj.intQuery(3), 0);
+    QCOMPARE(obj.stringQuery(), QString());
+
+    connect(&obj, &ReturnSignalObj::intQuery, [](int x) { return x * 2; });
+    connect(&obj, &ReturnSignalObj::stringQuery, [] { return QStringLiteral("hello"); });
+    QCOMPARE(obj.intQuery(3), 6);
+    QCOMPARE(obj.stringQuery(), QStringLiteral("hello"));
+
+    obj.blockSignals(true);
+    QCOMPARE(obj.intQuery(3), 0);
+    QCOMPARE(obj.stringQuery(), QString());
+}
+
+void tst_Basic::typedConnect()
+{
+    BTestObj sender;
+    BTestObj receiver;
+    QCOMPARE((w_internal::indexOfMethod<BTestObj, decltype(&BTestObj::anotherSignal), &BTestObj::anotherSignal>()), 3);
+    QCOMPARE((w_internal::indexOfMethod<BTestObj, decltype(&BTestObj::setValue), &BTestObj::setValue>()), 4);
+    QCOMPARE((w_internal::indexOfMethod<BTestObj, decltype(&BTestObj::getValue), &BTestObj::getValue>()), -1);
+
+    auto c = w_connect<decltype(&BTestObj::valueChanged), &BTestObj::valueChanged,
+                       decltype(&BTestObj::setValue), &BTestObj::setValue>(&sender, &receiver);
+    QVERIFY(c);
+    sender.setValue(QStringLiteral("hello"));
+    QCOMPARE(receiver.getValue(), QStringLiteral("hello"));
+
+    // A slot with less arguments, and a queued connection
+    QVERIFY((w_connect<decltype(&BTestObj::valueChanged), &BTestObj::valueChanged,
+                       decltype(&BTestObj::resetValue), &BTestObj::resetValue>(&receiver, &receiver, Qt::QueuedConnection)));
+    QObject::disconnect(c);
+    sender.setValue(QStringLiteral("world"));
+    QCOMPARE(receiver.getValue(), QStringLiteral("hello"));
+    receiver.setValue(QStringLiteral("world"));
+    QCOMPARE(receiver.getValue(), QStringLiteral("world"));
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.getValue(), QString());
+
+    // A queued connection with arguments
+    BTestObj queuedReceiver;
+    QVERIFY((w_connect<decltype(&BTestObj::valueChanged), &BTestObj::valueChanged,
+                       decltype(&BTestObj::setValue), &BTestObj::setValue>(&sender, &queuedReceiver, Qt::QueuedConnection)));
+    sender.setValue(QStringLiteral("queued"));
+    QCOMPARE(queuedReceiver.getValue(), QString());
+    QCoreApplication::processEvents();
+    QCOMPARE(queuedReceiver.getValue(), QStringLiteral("queued"));
+
+#if __cplusplus > 201700L
+    QVERIFY((w_connect<&BTestObj::simpleSignal, &BTestObj::anotherSignal>(&sender, &receiver)));
+    QSignalSpy spy(&receiver, &BTestObj::anotherSignal);
+    emit sender.simpleSignal();
+    QCOMPARE(spy.count(), 1);
+#endif
+}
+
+class ConnectionsObj : public QObject
+{   W_OBJECT(ConnectionsObj)
+public:
+    ConnectionsObj() : m_other(new BTestObj) {
+        m_other->setParent(this);
+        w_installConnections(this);
+    }
+
+    void forwardValue(const QString &s) W_SIGNAL(forwardValue, s)
+    void setValue(const QString &s) { value = s; }
+    W_SLOT(setValue)
+
+    QString value;
+    BTestObj m_child;
+    BTestObj *m_other;
+
+    W_CONNECTION(&ConnectionsObj::m_child, &BTestObj::valueChanged, W_This, &ConnectionsObj::setValue)
+    W_CONNECTION(W_This, &ConnectionsObj::forwardValue, &ConnectionsObj::m_other, &BTestObj::setValue)
+};
+
+W_OBJECT_IMPL(ConnectionsObj)
+
+void tst_Basic::declaredConnections()
+{
+    ConnectionsObj obj;
+    obj.m_child.setValue(QStringLiteral("from child"));
+    QCOMPARE(obj.value, QStringLiteral("from child"));
+    emit obj.forwardValue(QStringLiteral("to other"));
+    QCOMPARE(obj.m_other->getValue(), QStringLiteral("to other"));
+}
+
+void tst_Basic::queuedChannelConnect()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    BTestObj sender;
+    BTestObj receiver;
+    BTestObj otherReceiver;
+    QSignalSpy spy(&receiver, &BTestObj::valueChanged);
+    QSignalSpy otherSpy(&otherReceiver, &BTestObj::valueChanged);
+    QVERIFY((w_connectQueued<decltype(&BTestObj::valueChanged), &BTestObj::valueChanged,
+                             decltype(&BTestObj::setValue), &BTestObj::setValue>(&sender, &receiver)));
+    // Both connections share the queue of the main thread
+    QVERIFY((w_connectQueued<decltype(&BTestObj::valueChanged), &BTestObj::valueChanged,
+                             decltype(&BTestObj::setValue), &BTestObj::setValue>(&receiver, &otherReceiver)));
+    sender.setValue(QStringLiteral("a"));
+    sender.setValue(QStringLiteral("b"));
+    QCOMPARE(spy.count(), 0);
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(0).at(0).toString(), QStringLiteral("a"));
+    QCOMPARE(receiver.getValue(), QStringLiteral("b"));
+    // The calls pushed while delivering are delivered by the same drain
+    QCOMPARE(otherSpy.count(), 2);
+    QCOMPARE(otherReceiver.getValue(), QStringLiteral("b"));
+    // More calls than the initial capacity of the queue, which grows instead of posting them
+    for (int i = 0; i < 3000; ++i)
+        sender.setValue(QString::number(i));
+    while (spy.count() < 3002)
+        QCoreApplication::processEvents();
+    QCOMPARE(receiver.getValue(), QStringLiteral("2999"));
+    QCOMPARE(spy.at(1002).at(0).toString(), QStringLiteral("1000"));
+#endif
+}
+
+class CompressedObj : public QObject
+{   W_OBJECT(CompressedObj)
+public:
+    void progress(int value) W_SIGNAL(progress, value, W_Compressed)
+    void oldProgress(int value) W_SIGNAL_COMPAT(oldProgress, value, W_Compressed)
+    void setProgress(int value) { values.append(value); }
+    W_SLOT(setProgress)
+
+    QVector<int> values;
+};
+
+W_OBJECT_IMPL(CompressedObj)
+
+void tst_Basic::compressedSignal()
+{
+    // W_Compressed is not a Qt flag, it must not be written in the meta object
+    QMetaMethod progress = QMetaMethod::fromSignal(&CompressedObj::progress);
+    QCOMPARE(progress.methodType(), QMetaMethod::Signal);
+    QCOMPARE(progress.access(), QMetaMethod::Public);
+    QCOMPARE(progress.parameterNames(), QList<QByteArray>{"value"});
+    QMetaMethod oldProgress = QMetaMethod::fromSignal(&CompressedObj::oldProgress);
+    QCOMPARE(oldProgress.attributes(), int(QMetaMethod::Compatibility));
+    static_assert(w_internal::isCompressedSignal<CompressedObj, decltype(&CompressedObj::oldProgress), &CompressedObj::oldProgress>(), "");
+    static_assert(!w_internal::isCompressedSignal<BTestObj, decltype(&BTestObj::valueChanged), &BTestObj::valueChanged>(), "");
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    CompressedObj obj;
+    w_connectQueued<decltype(&CompressedObj::progress), &CompressedObj::progress,
+                    decltype(&CompressedObj::setProgress), &CompressedObj::setProgress>(&obj, &obj);
+    for (int i = 0; i < 10; ++i)
+        emit obj.progress(i);
+    QVERIFY(obj.values.isEmpty());
+    QCoreApplication::processEvents();
+    QCOMPARE(obj.values, QVector<int>{9});
+    emit obj.progress(10);
+    QCoreApplication::processEvents();
+    QCOMPARE(obj.values, (QVector<int>{9, 10}));
+#endif
+}
+
+struct NoEqualityOperator { int value; };
+Q_DECLARE_METATYPE(NoEqualityOperator)
+W_REGISTER_ARGTYPE(NoEqualityOperator)
+
+class MemberPropertyObj : public QObject
+{   W_OBJECT(MemberPropertyObj)
+public:
+    QString text;
+    NoEqualityOperator custom = {};
+
+    void textChanged() W_SIGNAL(textChanged)
+    void customChanged() W_SIGNAL(customChanged)
+
+    W_PROPERTY(QString, text MEMBER text NOTIFY textChanged)
+    W_PROPERTY(NoEqualityOperator, custom MEMBER custom NOTIFY customChanged)
+};
+
+W_OBJECT_IMPL(MemberPropertyObj)
+
+void tst_Basic::memberPropertyChange()
+{
+    MemberPropertyObj obj;
+    QSignalSpy textSpy(&obj, &MemberPropertyObj::textChanged);
+    // Many bindings writing the same value: only the first write changes it
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(obj.setProperty("text", QStringLiteral("hello")));
+    QCOMPARE(obj.text, QStringLiteral("hello"));
+    QCOMPARE(textSpy.count(), 1);
+    QVERIFY(obj.setProperty("text", QStringLiteral("world")));
+    QCOMPARE(textSpy.count(), 2);
+
+    // Without operator==, every write notifies
+    QSignalSpy customSpy(&obj, &MemberPropertyObj::customChanged);
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(obj.setProperty("custom", QVariant::fromValue(NoEqualityOperator{1})));
+    QCOMPARE(obj.custom.value, 1);
+    QCOMPARE(customSpy.count(), 3);
+}
+
+struct CopyCounter {
+    static int copies;
+    CopyCounter() = default;
+    CopyCounter(const CopyCounter &) { ++copies; }
+    CopyCounter(CopyCounter &&) = default;
+    CopyCounter &operator=(const CopyCounter &) { ++copies; return *this; }
+    CopyCounter &operator=(CopyCounter &&) = default;
+};
+int CopyCounter::copies = 0;
+Q_DECLARE_METATYPE(CopyCounter)
+W_REGISTER_ARGTYPE(CopyCounter)
+
+class MoveSetterObj : public QObject
+{   W_OBJECT(MoveSetterObj)
+public:
+    CopyCounter value;
+    void setByConstRef(const CopyCounter &v) { value = v; }
+    void setByRvalue(CopyCounter &&v) { value = std::move(v); }
+    void setByValue(CopyCounter v) { value = std::move(v); }
+
+    W_PROPERTY(CopyCounter, byConstRef WRITE setByConstRef)
+    W_PROPERTY(CopyCounter, byRvalue WRITE setByRvalue)
+    W_PROPERTY(CopyCounter, byValue WRITE setByValue)
+};
+
+W_OBJECT_IMPL(MoveSetterObj)
+
+void tst_Basic::moveAwareSetter()
+{
+    MoveSetterObj obj;
+    const QVariant v = QVariant::fromValue(CopyCounter());
+    auto copiesFor = [&](const char *name) {
+        const int before = CopyCounter::copies;
+        obj.setProperty(name, v);
+        return CopyCounter::copies - before;
+    };
+    const int constRefCopies = copiesFor("byConstRef");
+    // QMetaProperty::write owns the value it passes, so it is moved into the setter
+    QCOMPARE(copiesFor("byRvalue"), constRefCopies - 1);
+    QCOMPARE(copiesFor("byValue"), constRefCopies - 1);
+
+    // Through qt_metacall, the value is only moved when _a[1] is a QVariant holding it alone.
+    // Otherwise the caller keeps its value.
+    const int index = obj.metaObject()->indexOfProperty("byRvalue");
+    auto metacallCopies = [&](void *value, void *a1) {
+        int status = -1;
+        int flags = 0;
+        void *argv[] = { value, a1, &status, &flags };
+        const int before = CopyCounter::copies;
+        QMetaObject::metacall(&obj, QMetaObject::WriteProperty, index, argv);
+        return CopyCounter::copies - before;
+    };
+    CopyCounter value;
+    // Like QtQml
+    QCOMPARE(metacallCopies(&value, nullptr), 1);
+    // A QVariant which holds another value
+    QVariant other = QVariant::fromValue(CopyCounter());
+    QCOMPARE(metacallCopies(&value, &other), 1);
+    // Not a QVariant: zeroed memory, which is read as an invalid QVariant
+    alignas(QVariant) char notVariant[sizeof(QVariant)] = {};
+    QCOMPARE(metacallCopies(&value, notVariant), 1);
+    // A QVariant holding the value, but shared with another QVariant
+    QVariant shared = QVariant::fromValue(CopyCounter());
+    const QVariant sharedCopy = shared;
+    QCOMPARE(metacallCopies(const_cast<void *>(shared.constData()), &shared), 1);
+    // Like QMetaProperty::write
+    QVariant owned = QVariant::fromValue(CopyCounter());
+    QCOMPARE(metacallCopies(owned.data(), &owned), 0);
+}
+
+void tst_Basic::typedPropertyAccess()
+{
+    BTestObj obj;
+    using Value1 = w_property<BTestObj, w_indexOfProperty<BTestObj>("value1").relative>;
+    using Notify1 = w_property<BTestObj, w_indexOfProperty<BTestObj>("notify1").relative>;
+    static_assert(std::is_same<Value1::Type, QString>::value, "");
+    QCOMPARE(QByteArray(Value1::name()), QByteArray("value1"));
+
+    Value1::set(&obj, QStringLiteral("hello"));
+    QCOMPARE(obj.getValue(), QStringLiteral("hello"));
+    QCOMPARE(Value1::get(&obj), QStringLiteral("hello"));
+
+    QSignalSpy spy(&obj, &BTestObj::simpleSignal);
+    Notify1::set(&obj, QStringLiteral("member"));
+    Notify1::set(&obj, QStringLiteral("member"));
+    QCOMPARE(obj.member, QStringLiteral("member"));
+    QCOMPARE(spy.count(), 1);
+
+    // A const getter and a MEMBER property can be read from a const object
+    const BTestObj &constObj = obj;
+    QCOMPARE(Value1::get(&constObj), QStringLiteral("hello"));
+    QCOMPARE(Notify1::get(&constObj), QStringLiteral("member"));
+
+    // Same values as through the meta object
+    int count = 0;
+    w_forEachProperty<BTestObj>([&](auto prop) {
+        const QMetaProperty mp = obj.metaObject()->property(obj.metaObject()->indexOfProperty(prop.name()));
+        QCOMPARE(QVariant::fromValue(prop.get(&obj)), mp.read(&obj));
+        ++count;
+    });
+    QCOMPARE(count, BTestObj::staticMetaObject.propertyCount() - BTestObj::staticMetaObject.propertyOffset());
+}
+
+void tst_Basic::compileTimeIndexes()
+{
+    const QMetaObject &mo = BTestObj::staticMetaObject;
+    constexpr auto all = w_indexOfProperty<BTestObj>("all");
+    static_assert(all.isValid(), "");
+    static_assert(!w_indexOfProperty<BTestObj>("doesNotExist").isValid(), "");
+    QCOMPARE(int(all), mo.indexOfProperty("all"));
+    QCOMPARE(int(w_indexOfProperty<BTestObj>("valueNoex")), mo.indexOfProperty("valueNoex"));
+    QCOMPARE(int(w_indexOfProperty<BTestObj>("doesNotExist")), -1);
+
+    QCOMPARE(int(w_indexOfEnum<BTestObj>("XXX")), mo.indexOfEnumerator("XXX"));
+
+    QCOMPARE(int(w_indexOfMethod<decltype(&BTestObj::resetValue), &BTestObj::resetValue>()),
+             mo.indexOfMethod("resetValue()"));
+    QCOMPARE(int(w_indexOfMethod<decltype(&BTestObj::anotherSignal), &BTestObj::anotherSignal>()),
+             mo.indexOfMethod("anotherSignal()"));
+}
+
+class RepeatedNames : public QObject {
+    W_OBJECT(RepeatedNames)
+public:
+    int first = 1;
+    int second = 2;
+    W_PROPERTY(int, value MEMBER first)
+    W_PROPERTY(int, value MEMBER second)
+
+    enum Option { OptionA = 1, OptionB = 2 };
+    W_ENUM(Option, OptionA, OptionB)
+    W_DECLARE_FLAGS(Options, Option)
+    W_FLAG(Options, OptionA, OptionB)
+};
+
+W_OBJECT_IMPL(RepeatedNames)
+
+void tst_Basic::nameLookup()
+{
+    const QMetaObject &mo = BTestObj::staticMetaObject;
+    for (int i = mo.propertyOffset(); i < mo.propertyCount(); ++i)
+        QCOMPARE(int(w_indexOfProperty<BTestObj>(mo.property(i).name())), i);
+    for (int i = mo.methodOffset(); i < mo.methodCount(); ++i) {
+        const QByteArray signature = mo.method(i).methodSignature();
+        QCOMPARE(int(w_indexOfMethod<BTestObj>(signature.constData())), i);
+    }
+    QCOMPARE(int(w_indexOfEnum<BTestObj>("XXX")), mo.indexOfEnumerator("XXX"));
+
+    // Not found, or found in QObject
+    QCOMPARE(int(w_indexOfProperty<BTestObj>("doesNotExist")), -1);
+    QVERIFY(!w_indexOfProperty<BTestObj>("objectName").isValid());
+    QCOMPARE(int(w_indexOfProperty<BTestObj>("objectName")), mo.indexOfProperty("objectName"));
+    QCOMPARE(int(w_indexOfMethod<BTestObj>("setValue(int)")), -1);
+    QCOMPARE(int(w_indexOfMethod<BTestObj>("deleteLater()")), mo.indexOfMethod("deleteLater()"));
+    QCOMPARE(int(w_indexOfEnum<BTestObj>("YYY")), -1);
+
+    // Like QMetaObject, the last member with the name is found, and an enum name before an alias
+    const QMetaObject &repeated = RepeatedNames::staticMetaObject;
+    static_assert(w_indexOfProperty<RepeatedNames>("value").relative == 1, "");
+    QCOMPARE(int(w_indexOfProperty<RepeatedNames>("value")), repeated.indexOfProperty("value"));
+    static_assert(w_indexOfEnum<RepeatedNames>("Option").relative == 0, "");
+    QCOMPARE(int(w_indexOfEnum<RepeatedNames>("Option")), repeated.indexOfEnumerator("Option"));
+    QCOMPARE(int(w_indexOfEnum<RepeatedNames>("Options")), repeated.indexOfEnumerator("Options"));
+}
 
 struct My {};
 
@@ -266,6 +715,15 @@ void tst_Basic::abstractParent()
     QCOMPARE(ab->metaObject()->superClass(), &AbstractClass::staticMetaObject);
     QVERIFY(ab->setProperty("prop", 8989));
     QCOMPARE(ab->property("prop"), QVariant(8989));
+
+    // The index of w_indexOfProperty also selects the properties of the base class
+    using Prop = w_property<ConcreateClass, w_indexOfProperty<ConcreateClass>("prop").relative>;
+    using Prop2 = w_property<ConcreateClass, w_indexOfProperty<ConcreateClass>("prop2").relative>;
+    Prop::set(&cl, 1);
+    Prop2::set(&cl, 2);
+    QCOMPARE(cl.property("prop"), QVariant(1));
+    QCOMPARE(cl.property("prop2"), QVariant(2));
+    QCOMPARE(Prop::get(&cl), 1);
 }
 
 
@@ -389,11 +847,34 @@ void tst_Basic::testAccess()
 
 }
 
+struct DerivedFromAnotherTU : AnotherTU::BaseObject {
+    W_OBJECT(DerivedFromAnotherTU)
+public:
+    int m_derived = 2;
+    W_PROPERTY(int, derived MEMBER m_derived)
+    void setDerived(int value) { m_derived = value; }
+    W_SLOT(setDerived)
+};
+W_OBJECT_IMPL(DerivedFromAnotherTU)
+
 void tst_Basic::testAnotherTU()
 {
     auto mo = &AnotherTU::Gaga::staticMetaObject;
     QCOMPARE(mo->className(), "AnotherTU::Gaga");
 
+    // The base class is part of the qt_metacall chain even if its W_OBJECT_IMPL is in another file
+    static_assert(w_internal::IsVerdigrisObject<AnotherTU::BaseObject>::value, "");
+    static_assert(!w_internal::IsVerdigrisObject<QObject>::value, "");
+    DerivedFromAnotherTU obj;
+    QVERIFY(QMetaObject::invokeMethod(&obj, "setBase", Q_ARG(int, 10)));
+    QVERIFY(QMetaObject::invokeMethod(&obj, "setDerived", Q_ARG(int, 20)));
+    QCOMPARE(obj.m_base, 10);
+    QCOMPARE(obj.m_derived, 20);
+    QCOMPARE(obj.property("base").toInt(), 10);
+    QCOMPARE(obj.property("derived").toInt(), 20);
+    QVERIFY(obj.setProperty("base", 11));
+    QCOMPARE(obj.m_base, 11);
+
 #if defined (__cpp_inline_variables) && Q_CC_MSVC > 192000000
     auto mo2 = &AnotherTU::InlineGadget::staticMetaObject;
     QCOMPARE(mo2->className(), "AnotherTU::InlineGadget");